@@ -0,0 +1,125 @@
+/*
+ * Bulk byte-swap benchmark for NASA_SIMPLE_PROJECT.c
+ * ------------------------------------------------------------------
+ * Endian-converts a multi-megabyte buffer of 16/32/64-bit words in place
+ * and reports GB/s for:
+ *   memcpy    the same bytes copied to a second buffer, for scale
+ *   per-elem  one SWAP-based byte reversal per word, the word size only
+ *             known at run time (what one macro call per element costs)
+ *   bulk      BSWAP_BUFFER (section 5c)
+ * Every bulk result is checked against the per-element one first.
+ *
+ * Build and compare the vector paths (SSE2 baseline, pshufb, AVX2):
+ *   for f in -mno-ssse3 -mssse3 -mavx2; do
+ *     gcc -std=c11 -O2 -DFLIGHT_BUILD -DSIM_HW_REGS $f BSWAP_BENCH.c -o bswap && ./bswap
+ *   done
+ *
+ * Options:
+ *   -m <MiB>   buffer size (default 64)
+ *   -r <reps>  passes per measurement, best one is reported (default 10)
+ */
+
+#define NASA_NO_MAIN
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "NASA_SIMPLE_PROJECT.c"
+
+#include <unistd.h>
+
+/* Reference: the word size is a run-time value, so nothing vectorizes */
+static NOINLINE void swap_each(uint8_t *p, size_t n, unsigned w) {
+    for (size_t i = 0; i < n; ++i, p += w) {
+        for (unsigned k = 0; k < w / 2u; ++k) SWAP(p[k], p[w - 1u - k]);
+    }
+}
+
+static NOINLINE void bswap_bulk(uint8_t *p, size_t n, unsigned w) {
+    if (w == 2u)      BSWAP_BUFFER(p, n, 16);
+    else if (w == 4u) BSWAP_BUFFER(p, n, 32);
+    else              BSWAP_BUFFER(p, n, 64);
+}
+
+static NOINLINE void copy_once(uint8_t *dst, const uint8_t *src, size_t bytes) {
+    memcpy(dst, src, bytes);
+}
+
+/* Best-of-reps throughput of one pass over `bytes`, in GB/s */
+#define BEST_GBPS(reps, bytes, stmt) \
+    __extension__ ({ \
+        uint64_t _best = UINT64_MAX; \
+        for (unsigned _r = 0; _r < (reps); ++_r) { \
+            uint64_t _t0 = mono_ns(); \
+            stmt; \
+            uint64_t _dt = mono_ns() - _t0; \
+            if (_dt < _best) _best = _dt; \
+        } \
+        (double)(bytes) / (double)(_best ? _best : 1u); \
+    })
+
+int main(int argc, char *argv[]) {
+    size_t   mib  = 64;
+    unsigned reps = 10;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:r:")) != -1) {
+        switch (opt) {
+        case 'm': mib = strtoull(optarg, NULL, 10); break;
+        case 'r': reps = (unsigned)strtoul(optarg, NULL, 10); break;
+        default:
+            fprintf(stderr, "usage: %s [-m MiB] [-r reps]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (mib == 0) mib = 1;
+    if (reps == 0) reps = 1;
+    const size_t bytes = mib << 20;
+
+    uint8_t *src = aligned_alloc(64, bytes);
+    uint8_t *a   = aligned_alloc(64, bytes);
+    uint8_t *b   = aligned_alloc(64, bytes);
+    if (!src || !a || !b) { perror("aligned_alloc"); return EXIT_FAILURE; }
+    uint32_t lcg = 12345u;
+    for (size_t i = 0; i < bytes; ++i) {
+        lcg = lcg * 1664525u + 1013904223u;
+        src[i] = (uint8_t)(lcg >> 24);
+    }
+
+    printf("bswap bench: %zu MiB, best of %u, %s\n", mib, reps,
+#if defined(__AVX2__)
+           "AVX2 pshufb"
+#elif defined(__SSSE3__)
+           "SSSE3 pshufb"
+#elif defined(__SSE2__)
+           "SSE2 shifts/shuffles"
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+           "NEON rev"
+#else
+           "scalar bswap"
+#endif
+    );
+    memcpy(a, src, bytes);                 /* fault the pages in */
+    memcpy(b, src, bytes);
+    double gb_copy = BEST_GBPS(reps, bytes, copy_once(a, src, bytes));
+    printf("%-6s %10s %10.2f GB/s\n", "", "memcpy", gb_copy);
+
+    int bad = 0;
+    for (unsigned w = 2u; w <= 8u; w *= 2u) {
+        const size_t n = bytes / w - 1u;   /* odd count: exercises the scalar tail */
+        memcpy(a, src, n * w);
+        memcpy(b + 1, src, n * w);         /* misaligned on purpose */
+        swap_each(a, n, w);
+        bswap_bulk(b + 1, n, w);
+        if (memcmp(a, b + 1, n * w) != 0) {
+            printf("%2u-bit: bulk result differs from per-element reference\n", w * 8u);
+            bad = 1;
+            continue;
+        }
+        double gb_each = BEST_GBPS(reps, n * w, swap_each(a, n, w));
+        double gb_bulk = BEST_GBPS(reps, n * w, bswap_bulk(a, n, w));
+        printf("%2u-bit %10s %10.2f GB/s\n", w * 8u, "per-elem", gb_each);
+        printf("%2u-bit %10s %10.2f GB/s  (%.1fx per-elem)\n", w * 8u, "bulk",
+               gb_bulk, gb_bulk / gb_each);
+    }
+    free(src);
+    free(a);
+    free(b);
+    return bad ? EXIT_FAILURE : EXIT_SUCCESS;
+}
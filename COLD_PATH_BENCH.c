@@ -0,0 +1,68 @@
+/*
+ * Inline vs. outlined SAFE_CALL/ASSERT failure paths
+ * ------------------------------------------------------------------
+ * hot_checks() holds 32 SAFE_CALL and 32 ASSERT sites, as a stand-in for
+ * a check-heavy control function. Build it both ways, then compare the
+ * hot function's code size and the time per pass:
+ *
+ *   for o in 0 1; do
+ *     gcc -std=c11 -O2 -DGROUND_BUILD -DSIM_HW_REGS -DCFG_OUTLINE_FAILURES=$o \
+ *         COLD_PATH_BENCH.c -o cold_$o
+ *     nm -S --size-sort cold_$o | grep -E ' hot_checks$'
+ *     ./cold_$o
+ *   done
+ *
+ * "./cold_N -f safe|assert" triggers the last site of that kind, so the
+ * failure output of both builds can be diffed; "-f segv" logs one line
+ * and then faults.
+ *
+ * With the binary log, every one of these must leave a dump that still
+ * holds its last record (the ASSERT/SAFE_CALL line, or the one before
+ * the fault), although abort() and SIGSEGV skip atexit:
+ *
+ *   gcc -std=c11 -O2 -DGROUND_BUILD -DSIM_HW_REGS -DCFG_LOG_BINARY=1 COLD_PATH_BENCH.c -o cold_bin
+ *   gcc -std=c11 -O2 -DGROUND_BUILD -DSIM_HW_REGS -DCFG_LOG_BINARY=1 NASA_LOG_DECODER.c -o nasa_logdec
+ *   for f in safe assert segv; do
+ *     rm -f nasa_log.bin; ./cold_bin -f $f; ./nasa_logdec nasa_log.bin | tail -1
+ *   done
+ */
+
+#define NASA_NO_MAIN
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "NASA_SIMPLE_PROJECT.c"
+
+static volatile int fail_rc;       /* set by -f safe   */
+static volatile int assert_ok = 1; /* cleared by -f assert */
+
+static NOINLINE int step(int i) { return i == 31 ? fail_rc : 0; }
+
+static volatile int *volatile fault_at; /* NULL: -f segv writes through it */
+
+#define CHECK_PAIR(i) SAFE_CALL(step(i)); ASSERT(assert_ok || (i) != 31);
+#define CHECK_8(b) CHECK_PAIR(b) CHECK_PAIR(b + 1) CHECK_PAIR(b + 2) CHECK_PAIR(b + 3) \
+                   CHECK_PAIR(b + 4) CHECK_PAIR(b + 5) CHECK_PAIR(b + 6) CHECK_PAIR(b + 7)
+
+static NOINLINE void hot_checks(void) {
+    CHECK_8(0) CHECK_8(8) CHECK_8(16) CHECK_8(24)
+}
+
+int main(int argc, char *argv[]) {
+    if (argc == 3 && !strcmp(argv[1], "-f")) {
+        if (!strcmp(argv[2], "safe")) fail_rc = ERR_SENSOR_FAIL;
+        else if (!strcmp(argv[2], "assert")) assert_ok = 0;
+        else if (!strcmp(argv[2], "segv")) {
+            LOGF("about to fault");
+            *fault_at = 1;
+        }
+        hot_checks();
+        return 0;
+    }
+    enum { PASSES = 2000000 };
+    for (int i = 0; i < PASSES / 100; ++i) hot_checks();
+    uint64_t t0 = mono_ns(), c0 = cycles_now();
+    for (int i = 0; i < PASSES; ++i) hot_checks();
+    uint64_t c1 = cycles_now(), t1 = mono_ns();
+    printf("CFG_OUTLINE_FAILURES=%d: %.2f ns/pass, %.1f ticks/pass (64 checks)\n",
+           CFG_OUTLINE_FAILURES, (double)(t1 - t0) / PASSES, (double)(c1 - c0) / PASSES);
+    return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * Start-up latency: process start to first valid control tick
+ * ------------------------------------------------------------------
+ * Spawns itself N times as a child that does exactly what main() does
+ * before its first tick (profile lookup, init_system(), one control tick),
+ * sends back its timestamps and exits. CLOCK_MONOTONIC is system-wide, so
+ * each start splits into
+ *   exec    parent's spawn call to the child's first constructor
+ *           (kernel exec, dynamic loader, relocations)
+ *   start   constructor to the first tick that returned ERR_OK
+ *           (everything this unit does: section 8b)
+ * first with no warm file (cold), then restoring the one the previous
+ * child saved (warm).
+ *
+ * Build (flight: no logs on the path being measured):
+ *   gcc -std=c11 -O2 -DFLIGHT_BUILD -DSIM_HW_REGS -DCFG_WARM_START=1 \
+ *       COLD_START_BENCH.c -o nasa_coldstart && ./nasa_coldstart
+ *   add -static-pie or -static to see the loader's share shrink
+ *
+ * Options:
+ *   -n <N>    starts per mode (default 200)
+ */
+
+#define NASA_NO_MAIN
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "NASA_SIMPLE_PROJECT.c"
+
+#include <spawn.h>
+#include <sys/wait.h>
+
+#if !CFG_WARM_START || !defined(SIM_HW_REGS) || !(defined(__GNUC__) || defined(__clang__))
+#  error "COLD_START_BENCH.c needs the warm file and simulated registers: build with -DSIM_HW_REGS -DCFG_WARM_START=1"
+#endif
+
+#define CHILD_FD 3
+
+extern char **environ;
+
+typedef struct { uint64_t boot_ns, first_tick_ns; int32_t rc, warm; } start_report_t;
+
+/* The child: main()'s start-up, up to and including the first valid tick */
+static int child_main(void) {
+    start_report_t r = { 0 };
+    g_ctl_profile = control_profile_find(CFG_CONTROL_PROFILE);
+    if (!g_ctl_profile) return EXIT_FAILURE;
+    r.rc = init_system();
+    r.warm = (int32_t)g_warm->restores;
+    for (int i = 0; r.rc == ERR_OK && i < 100 && !boot_first_tick_ns; ++i) {
+        (void)boot_note_tick(g_ctl_profile->control_once());
+    }
+    r.boot_ns = boot_ns;
+    r.first_tick_ns = boot_first_tick_ns;
+    return write(CHILD_FD, &r, sizeof r) == (ssize_t)sizeof r && r.first_tick_ns ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char *what, uint64_t *v, unsigned n) {
+    qsort(v, n, sizeof *v, cmp_u64);
+    printf("  %-6s min %8.1f us  p50 %8.1f us  p99 %8.1f us\n", what, (double)v[0] / 1e3,
+           (double)v[n / 2u] / 1e3, (double)v[(size_t)((double)n * 0.99)] / 1e3);
+}
+
+/* One spawned start; 0 on success */
+static int one_start(const char *self, uint64_t *exec_ns, uint64_t *start_ns, int32_t *warm) {
+    int fds[2];
+    if (pipe(fds) != 0) return -1;
+    posix_spawn_file_actions_t fa;
+    posix_spawn_file_actions_init(&fa);
+    posix_spawn_file_actions_adddup2(&fa, fds[1], CHILD_FD);
+    char *argv[] = { (char *)self, (char *)"-c", NULL };
+    pid_t pid;
+    uint64_t t0 = mono_ns();
+    int rc = posix_spawn(&pid, self, &fa, NULL, argv, environ);
+    posix_spawn_file_actions_destroy(&fa);
+    close(fds[1]);
+    start_report_t r;
+    ssize_t got = rc == 0 ? read(fds[0], &r, sizeof r) : -1;
+    close(fds[0]);
+    int status = 0;
+    if (rc == 0) waitpid(pid, &status, 0);
+    if (got != (ssize_t)sizeof r || !WIFEXITED(status) || WEXITSTATUS(status) != 0) return -1;
+    *exec_ns  = r.boot_ns - t0;
+    *start_ns = r.first_tick_ns - r.boot_ns;
+    *warm     = r.warm;
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned n = 200;
+    int opt;
+    while ((opt = getopt(argc, argv, "cn:")) != -1) {
+        switch (opt) {
+        case 'c': return child_main();
+        case 'n': n = (unsigned)strtoul(optarg, NULL, 10); break;
+        default:
+            fprintf(stderr, "usage: %s [-n starts]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (n == 0) n = 1;
+
+    uint64_t *exec_ns = calloc(n, sizeof *exec_ns), *start_ns = calloc(n, sizeof *start_ns);
+    if (!exec_ns || !start_ns) { perror("calloc"); return EXIT_FAILURE; }
+    printf("start-up bench: %u starts per mode, profile %s, warm file %s\n", n, CFG_CONTROL_PROFILE,
+           CFG_WARM_STATE_PATH);
+    for (int mode = 0; mode < 2; ++mode) {
+        for (unsigned i = 0; i < n; ++i) {
+            if (mode == 0) unlink(CFG_WARM_STATE_PATH);
+            int32_t warm = 0;
+            if (one_start("/proc/self/exe", &exec_ns[i], &start_ns[i], &warm) != 0) {
+                fprintf(stderr, "start %u failed\n", i);
+                return EXIT_FAILURE;
+            }
+            if ((warm > 0) != (mode == 1)) {
+                fprintf(stderr, "start %u: expected a %s start\n", i, mode ? "warm" : "cold");
+                return EXIT_FAILURE;
+            }
+        }
+        printf("%s\n", mode ? "warm (state restored from the last child's file)" : "cold (no warm file)");
+        report("exec", exec_ns, n);
+        report("start", start_ns, n);
+    }
+    unlink(CFG_WARM_STATE_PATH);
+    free(exec_ns);
+    free(start_ns);
+    return EXIT_SUCCESS;
+}
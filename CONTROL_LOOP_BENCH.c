@@ -0,0 +1,184 @@
+/*
+ * Control-loop latency benchmark for NASA_SIMPLE_PROJECT.c
+ * ------------------------------------------------------------------
+ * Runs run_control_loop_once() (or a specialized profile of it, -p)
+ * millions of times against the simulated register file, pinned to one
+ * core, and reports mean cycles/iteration, latency percentiles and an
+ * HDR-style (log-linear) histogram.
+ *
+ * Build and run both profiles (compare them before flight SW review):
+ *   for p in GROUND_BUILD FLIGHT_BUILD; do
+ *     gcc -std=c11 -O2 -D$p -DSIM_HW_REGS CONTROL_LOOP_BENCH.c -o bench_$p && ./bench_$p
+ *   done
+ *
+ * Options:
+ *   -p <name>   control profile from the section 10b table, ticked through
+ *               its function pointer (default "generic": run_control_loop_once)
+ *   -n <iters>  timed iterations (default 5000000)
+ *   -c <cpu>    core to pin to (default: the core we start on)
+ *   -v          keep LOGF/TRACE output on stderr (default: /dev/null)
+ *
+ * Ground builds still pay for their log formatting (to /dev/null); add
+ * -DCFG_LOG_BINARY=1 to measure the deferred-format backend instead.
+ * Per-iteration stamps come from cycles_now(), so each sample includes
+ * one counter read (reported as "timer overhead").
+ */
+
+#define _GNU_SOURCE                  /* sched_setaffinity, sched_getcpu */
+#define NASA_NO_MAIN
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "NASA_SIMPLE_PROJECT.c"
+
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+
+#ifndef SIM_HW_REGS
+#  error "CONTROL_LOOP_BENCH.c runs against the simulated registers: build with -DSIM_HW_REGS"
+#endif
+
+/* HDR-style histogram: 32 linear sub-buckets per power of two (~3% error) */
+#define HIST_SUB_BITS  5u
+#define HIST_SUB       (1u << HIST_SUB_BITS)
+#define HIST_BUCKETS   (64u * HIST_SUB)
+
+static uint64_t hist[HIST_BUCKETS];
+
+static inline unsigned hist_index(uint64_t v) {
+    if (v < 2u * HIST_SUB) return (unsigned)v;
+    unsigned msb   = 63u - (unsigned)__builtin_clzll(v);
+    unsigned shift = msb - HIST_SUB_BITS;
+    return (shift + 1u) * HIST_SUB + (unsigned)((v >> shift) - HIST_SUB);
+}
+
+static uint64_t hist_low(unsigned idx) {
+    if (idx < 2u * HIST_SUB) return idx;
+    unsigned shift = idx / HIST_SUB - 1u;
+    return (uint64_t)(idx % HIST_SUB + HIST_SUB) << shift;
+}
+
+static uint64_t hist_percentile(uint64_t total, double pct) {
+    uint64_t want = (uint64_t)((double)total * pct / 100.0 + 0.5), seen = 0;
+    if (want == 0) want = 1;
+    for (unsigned i = 0; i < HIST_BUCKETS; ++i) {
+        seen += hist[i];
+        if (seen >= want) return hist_low(i);
+    }
+    return 0;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t iters = 5000000u;
+    int cpu = -1, verbose = 0, opt;
+    const char *profile = "generic";
+    while ((opt = getopt(argc, argv, "p:n:c:v")) != -1) {
+        switch (opt) {
+        case 'p': profile = optarg; break;
+        case 'n': iters = strtoull(optarg, NULL, 10); break;
+        case 'c': cpu = atoi(optarg); break;
+        case 'v': verbose = 1; break;
+        default:
+            fprintf(stderr, "usage: %s [-p profile] [-n iters] [-c cpu] [-v]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    const control_profile_t *prof = control_profile_find(profile);
+    if (!prof) {
+        fprintf(stderr, "unknown profile \"%s\"; have:", profile);
+        for (size_t i = 0; i < CONTROL_PROFILE_COUNT; ++i) fprintf(stderr, " %s", control_profiles[i].name);
+        fputc('\n', stderr);
+        return EXIT_FAILURE;
+    }
+    int (*const tick)(void) = prof->control_once;
+    if (iters == 0) iters = 1;
+    if (cpu < 0) cpu = sched_getcpu();
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu < 0 ? 0 : cpu, &set);
+    if (sched_setaffinity(0, sizeof set, &set) != 0) perror("sched_setaffinity (running unpinned)");
+    int saved_stderr = -1;
+    if (!verbose) {
+        int devnull = open("/dev/null", O_WRONLY);
+        fflush(stderr);
+        saved_stderr = dup(STDERR_FILENO);
+        if (devnull >= 0) { dup2(devnull, STDERR_FILENO); close(devnull); }
+    }
+
+    SAFE_CALL(init_system());
+
+    /* Timer overhead: back-to-back counter reads */
+    uint64_t ovh = UINT64_MAX;
+    for (int i = 0; i < 1000; ++i) {
+        uint64_t a = cycles_now(), b = cycles_now();
+        if (b - a < ovh) ovh = b - a;
+    }
+
+    /* Warm caches and branch predictors, exercising both policy branches */
+    for (uint64_t i = 0; i < iters / 100u + 1000u; ++i) {
+        SIM_SENSOR_SAMPLE(i & 63u);
+        (void)tick();
+    }
+
+    uint64_t max = 0, sum = 0, errors = 0;
+    double   w0 = now_ns();
+    uint64_t c0 = cycles_now();
+    for (uint64_t i = 0; i < iters; ++i) {
+        SIM_SENSOR_SAMPLE(i & 63u);
+        uint64_t t0 = cycles_now();
+        int rc = tick();
+        uint64_t dt = cycles_now() - t0;
+        errors += rc != ERR_OK;
+        sum += dt;
+        if (dt > max) max = dt;
+        hist[hist_index(dt)]++;
+    }
+    uint64_t c1 = cycles_now();
+    double   w1 = now_ns();
+    double   ns_per_tick = (w1 - w0) / (double)(c1 - c0);
+
+    DISABLE_SYSTEM();
+    if (saved_stderr >= 0) {
+        fflush(stderr);
+        dup2(saved_stderr, STDERR_FILENO);
+        close(saved_stderr);
+    }
+
+    printf("control-loop bench: %s, profile %s (%u N), logs=%d, asserts=%d, cpu=%d\n",
+#if defined(FLIGHT_BUILD)
+           "FLIGHT_BUILD",
+#else
+           "GROUND_BUILD",
+#endif
+           prof->name, (unsigned)prof->max_thrust_n, CFG_ENABLE_LOGS, CFG_ENABLE_ASSERTS, cpu);
+    printf("iterations        %llu (%llu errors)\n", (unsigned long long)iters,
+           (unsigned long long)errors);
+    printf("timer overhead    %llu ticks\n", (unsigned long long)ovh);
+    printf("tick period       %.3f ns\n", ns_per_tick);
+    printf("mean              %.1f ticks/iter  (%.1f ns)\n", (double)sum / (double)iters,
+           (double)sum / (double)iters * ns_per_tick);
+    static const double pct[] = { 50.0, 90.0, 99.0, 99.9, 99.99 };
+    for (size_t i = 0; i < sizeof pct / sizeof pct[0]; ++i) {
+        uint64_t v = hist_percentile(iters, pct[i]);
+        printf("p%-16g %llu ticks  (%.1f ns)\n", pct[i], (unsigned long long)v,
+               (double)v * ns_per_tick);
+    }
+    printf("max               %llu ticks  (%.1f ns)\n", (unsigned long long)max,
+           (double)max * ns_per_tick);
+
+    printf("\n%12s %12s %10s %9s\n", "ticks>=", "ns>=", "count", "cum%");
+    uint64_t cum = 0;
+    for (unsigned i = 0; i < HIST_BUCKETS; ++i) {
+        if (!hist[i]) continue;
+        cum += hist[i];
+        printf("%12llu %12.1f %10llu %8.4f%%\n", (unsigned long long)hist_low(i),
+               (double)hist_low(i) * ns_per_tick, (unsigned long long)hist[i],
+               100.0 * (double)cum / (double)iters);
+    }
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,234 @@
+/*
+ * Trace replay for NASA_SIMPLE_PROJECT.c
+ * ------------------------------------------------------------------
+ * Drives the control loop from a recorded register trace as fast as the
+ * loop runs. The input trace is mmap'ed and each tick's hardware-owned
+ * registers (STATUS, SENS_TEMP) are copied into the simulated hw_regs_t;
+ * after run_control_loop_once() the software-owned outputs (THRUST, CTRL)
+ * and the return code go straight into a second mapped file. There is no
+ * per-sample read()/write() and no parsing.
+ *
+ * Build:
+ *   gcc -std=c11 -O2 -DFLIGHT_BUILD -DSIM_HW_REGS CONTROL_LOOP_REPLAY.c -o nasa_replay
+ *
+ * Run:
+ *   ./nasa_replay -g 86400000 day.trace          generate a synthetic trace
+ *   ./nasa_replay day.trace day.out              replay -> outputs
+ *   ./nasa_replay day.trace new.out golden.out   replay and diff vs. golden
+ *   ./nasa_replay -G 86400000 be.trace           same trace, byte-swapped (as
+ *                                                a big-endian recorder writes it)
+ *   (-v keeps LOGF/TRACE output; by default stderr is silenced during replay)
+ *   Add -DCFG_BRANCH_PROFILE=1 to check the LIKELY/UNLIKELY hints against
+ *   the trace: the [BRANCH] report and nasa_branch.csv appear at exit.
+ *
+ * File layouts (native endianness):
+ *   trace:  replay_hdr_t { "NRPL", 1, nticks } + nticks x replay_in_t
+ *   output: replay_hdr_t { "NRPO", 1, nticks } + nticks x replay_out_t
+ * Inputs in the other byte order are mapped copy-on-write and converted
+ * in place with BSWAP_BUFFER before the replay starts.
+ */
+
+#define NASA_NO_MAIN
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "NASA_SIMPLE_PROJECT.c"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef SIM_HW_REGS
+#  error "CONTROL_LOOP_REPLAY.c drives the simulated registers: build with -DSIM_HW_REGS"
+#endif
+
+#define REPLAY_MAGIC_IN   0x4C50524Eu  /* "NRPL" */
+#define REPLAY_MAGIC_OUT  0x4F50524Eu  /* "NRPO" */
+#define REPLAY_VERSION    1u
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t nticks;
+} replay_hdr_t;
+
+typedef struct {           /* one recorded hw_regs_t snapshot */
+    uint32_t CTRL;
+    uint32_t STATUS;
+    uint32_t THRUST;
+    uint32_t SENS_TEMP;
+} replay_in_t;
+
+typedef struct {
+    uint32_t THRUST;
+    uint32_t CTRL;
+    int32_t  rc;
+    uint32_t reserved;
+} replay_out_t;
+
+STATIC_ASSERT(sizeof(replay_in_t) == sizeof(hw_snapshot_t), replay_record_matches_hw_regs);
+
+typedef struct {
+    void  *base;
+    size_t len;
+} mapping_t;
+
+static int map_file(const char *path, int writable, size_t len, mapping_t *m) {
+    int fd = open(path, writable ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDONLY, 0644);
+    if (fd < 0) { perror(path); return -1; }
+    if (writable) {
+        if (ftruncate(fd, (off_t)len) != 0) { perror(path); close(fd); return -1; }
+    } else {
+        struct stat st;
+        if (fstat(fd, &st) != 0) { perror(path); close(fd); return -1; }
+        len = (size_t)st.st_size;
+    }
+    if (len < sizeof(replay_hdr_t)) {
+        fprintf(stderr, "%s: too short\n", path);
+        close(fd);
+        return -1;
+    }
+    /* Inputs are private so a byte-swapped file can be converted in place */
+    void *p = mmap(NULL, len, PROT_READ | PROT_WRITE, writable ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) { perror(path); return -1; }
+    (void)madvise(p, len, MADV_SEQUENTIAL);
+    m->base = p;
+    m->len  = len;
+    return 0;
+}
+
+/* Records are all 32-bit fields, so the other byte order converts word-wise */
+STATIC_ASSERT(sizeof(replay_in_t) % 4 == 0 && sizeof(replay_out_t) % 4 == 0, records_are_32bit_words);
+
+static void hdr_bswap(replay_hdr_t *h) {
+    h->magic   = __builtin_bswap32(h->magic);
+    h->version = __builtin_bswap32(h->version);
+    h->nticks  = __builtin_bswap64(h->nticks);
+}
+
+static const replay_hdr_t *check_hdr(const mapping_t *m, uint32_t magic, size_t rec, const char *path) {
+    replay_hdr_t *h = m->base;
+    int swapped = h->magic == __builtin_bswap32(magic);
+    if (swapped) hdr_bswap(h);
+    if (h->magic != magic || h->version != REPLAY_VERSION) {
+        fprintf(stderr, "%s: bad magic/version\n", path);
+        return NULL;
+    }
+    if (h->nticks > (m->len - sizeof *h) / rec) {
+        fprintf(stderr, "%s: truncated (%llu ticks declared)\n", path, (unsigned long long)h->nticks);
+        return NULL;
+    }
+    if (swapped) {
+        uint64_t t0 = mono_ns();
+        BSWAP_BUFFER(h + 1, h->nticks * rec / 4u, 32);
+        printf("%s: byte-swapped, converted %llu bytes in %.3f ms\n", path,
+               (unsigned long long)(h->nticks * rec), (double)(mono_ns() - t0) / 1e6);
+    }
+    return h;
+}
+
+/* Synthetic trace: slow thermal cycle crossing the policy split, plus noise */
+static int generate(const char *path, uint64_t nticks, int swapped) {
+    mapping_t m;
+    if (map_file(path, 1, sizeof(replay_hdr_t) + nticks * sizeof(replay_in_t), &m) != 0) return -1;
+    replay_hdr_t *h = m.base;
+    *h = (replay_hdr_t){ REPLAY_MAGIC_IN, REPLAY_VERSION, nticks };
+    replay_in_t *in = (replay_in_t *)(h + 1);
+    uint32_t lcg = 12345u;
+    for (uint64_t i = 0; i < nticks; ++i) {
+        lcg = lcg * 1664525u + 1013904223u;
+        uint32_t phase = (uint32_t)(i % 60000u);
+        uint32_t tri   = phase < 30000u ? phase : 60000u - phase;   /* 0..30000 */
+        in[i] = (replay_in_t){ 0, 0, 0, 15u + tri / 1000u + (lcg >> 30) };
+    }
+    if (swapped) {
+        BSWAP_BUFFER(in, nticks * sizeof(replay_in_t) / 4u, 32);
+        hdr_bswap(h);
+    }
+    return munmap(m.base, m.len);
+}
+
+static int replay(const char *in_path, const char *out_path, const char *golden_path, int verbose) {
+    mapping_t mi, mo, mg = { NULL, 0 };
+    if (map_file(in_path, 0, 0, &mi) != 0) return -1;
+    const replay_hdr_t *hi = check_hdr(&mi, REPLAY_MAGIC_IN, sizeof(replay_in_t), in_path);
+    if (!hi) return -1;
+    uint64_t n = hi->nticks;
+    if (map_file(out_path, 1, sizeof(replay_hdr_t) + n * sizeof(replay_out_t), &mo) != 0) return -1;
+    const replay_in_t *in  = (const replay_in_t *)(hi + 1);
+    replay_hdr_t      *ho  = mo.base;
+    replay_out_t      *out = (replay_out_t *)(ho + 1);
+
+    int saved_stderr = -1;
+    if (!verbose) {
+        int devnull = open("/dev/null", O_WRONLY);
+        fflush(stderr);
+        saved_stderr = dup(STDERR_FILENO);
+        if (devnull >= 0) { dup2(devnull, STDERR_FILENO); close(devnull); }
+    }
+
+    int init_rc = init_system();
+    uint64_t t0 = mono_ns();
+    for (uint64_t i = 0; i < n && init_rc == 0; ++i) {
+        REG32(STATUS)    = in[i].STATUS;
+        SIM_SENSOR_SAMPLE(in[i].SENS_TEMP);
+        int rc = run_control_loop_once();
+        out[i] = (replay_out_t){ REG32(THRUST), REG32(CTRL), rc, 0 };
+    }
+    uint64_t t1 = mono_ns();
+    *ho = (replay_hdr_t){ REPLAY_MAGIC_OUT, REPLAY_VERSION, n };
+
+    if (saved_stderr >= 0) {
+        fflush(stderr);
+        dup2(saved_stderr, STDERR_FILENO);
+        close(saved_stderr);
+    }
+    if (init_rc != 0) { fprintf(stderr, "init_system failed: %s\n", error_to_str(init_rc)); return -1; }
+    printf("replayed %llu ticks in %.3f s (%.1f ns/tick)\n", (unsigned long long)n,
+           (double)(t1 - t0) / 1e9, n ? (double)(t1 - t0) / (double)n : 0.0);
+
+    int rc = 0;
+    if (golden_path) {
+        if (map_file(golden_path, 0, 0, &mg) != 0) return -1;
+        const replay_hdr_t *hg = check_hdr(&mg, REPLAY_MAGIC_OUT, sizeof(replay_out_t), golden_path);
+        if (!hg) return -1;
+        const replay_out_t *gold = (const replay_out_t *)(hg + 1);
+        uint64_t common = hg->nticks < n ? hg->nticks : n, diffs = 0, first = 0;
+        for (uint64_t i = 0; i < common; ++i) {
+            if (memcmp(&out[i], &gold[i], sizeof out[i]) != 0 && diffs++ == 0) first = i;
+        }
+        if (hg->nticks != n) printf("tick count differs: %llu vs golden %llu\n",
+                                    (unsigned long long)n, (unsigned long long)hg->nticks);
+        if (diffs) {
+            printf("%llu ticks differ; first at tick %llu: THRUST=%u CTRL=0x%x rc=%d "
+                   "(golden THRUST=%u CTRL=0x%x rc=%d)\n",
+                   (unsigned long long)diffs, (unsigned long long)first,
+                   (unsigned)out[first].THRUST, (unsigned)out[first].CTRL, (int)out[first].rc,
+                   (unsigned)gold[first].THRUST, (unsigned)gold[first].CTRL, (int)gold[first].rc);
+        } else {
+            printf("outputs match golden\n");
+        }
+        rc = (diffs || hg->nticks != n) ? 1 : 0;
+        munmap(mg.base, mg.len);
+    }
+    munmap(mi.base, mi.len);
+    munmap(mo.base, mo.len);
+    return rc;
+}
+
+int main(int argc, char *argv[]) {
+    int verbose = argc > 1 && !strcmp(argv[1], "-v");
+    argv += verbose;
+    argc -= verbose;
+    if (argc == 4 && (!strcmp(argv[1], "-g") || !strcmp(argv[1], "-G"))) {
+        int rc = generate(argv[3], strtoull(argv[2], NULL, 10), argv[1][1] == 'G');
+        return rc == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (argc != 3 && argc != 4) {
+        fprintf(stderr, "usage: %s -g|-G <ticks> <trace>\n"
+                        "       %s [-v] <trace> <out> [golden]\n", argv[0], argv[0]);
+        return EXIT_FAILURE;
+    }
+    int rc = replay(argv[1], argv[2], argc == 4 ? argv[3] : NULL, verbose);
+    return rc == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,100 @@
+/*
+ * Register-file false-sharing benchmark
+ * ------------------------------------------------------------------
+ * One thread writes THRUST as fast as it can (the control core) while
+ * another polls STATUS (a health monitor). With the packed hw_regs_t both
+ * registers sit in one cache line, which ping-pongs between the cores on
+ * every write; with CFG_SPLIT_REGS=1 each register owns a line and the
+ * two threads stop interfering. Build both layouts and compare:
+ *
+ *   for s in 0 1; do
+ *     gcc -std=c11 -O2 -DFLIGHT_BUILD -DSIM_HW_REGS -DCFG_SPLIT_REGS=$s -pthread \
+ *         FALSE_SHARING_BENCH.c -o fs_$s && ./fs_$s -c 0,1
+ *   done
+ *
+ * Options:
+ *   -n <writes>   THRUST writes timed (default 100000000)
+ *   -c <w>,<p>    cores for the writer and the poller (default 0,1);
+ *                 pick two physical cores, not SMT siblings
+ */
+
+#define _GNU_SOURCE                  /* pthread_setaffinity_np */
+#define NASA_NO_MAIN
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "NASA_SIMPLE_PROJECT.c"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stddef.h>
+#include <unistd.h>
+
+#ifndef SIM_HW_REGS
+#  error "FALSE_SHARING_BENCH.c measures the simulated register file: build with -DSIM_HW_REGS"
+#endif
+
+static _Atomic int      g_go;
+static _Atomic int      g_stop;
+static _Atomic uint64_t g_polls;
+
+static void pin(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof set, &set) != 0) {
+        fprintf(stderr, "cannot pin to cpu %d (running unpinned)\n", cpu);
+    }
+}
+
+static void *poller_main(void *arg) {
+    pin((int)(intptr_t)arg);
+    uint64_t polls = 0;
+    while (!atomic_load_explicit(&g_go, memory_order_acquire)) {}
+    while (!atomic_load_explicit(&g_stop, memory_order_relaxed)) {
+        (void)REG32(STATUS);         /* volatile: one load per poll */
+        ++polls;
+    }
+    atomic_store(&g_polls, polls);
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t writes = 100000000u;
+    int wcpu = 0, pcpu = 1, opt;
+    while ((opt = getopt(argc, argv, "n:c:")) != -1) {
+        switch (opt) {
+        case 'n': writes = strtoull(optarg, NULL, 10); break;
+        case 'c':
+            if (sscanf(optarg, "%d,%d", &wcpu, &pcpu) != 2) wcpu = -1;
+            break;
+        default: wcpu = -1; break;
+        }
+        if (wcpu < 0) {
+            fprintf(stderr, "usage: %s [-n writes] [-c writer_cpu,poller_cpu]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (writes == 0) writes = 1;
+
+    pthread_t poller;
+    pin(wcpu);
+    if (pthread_create(&poller, NULL, poller_main, (void *)(intptr_t)pcpu) != 0) {
+        perror("pthread_create");
+        return EXIT_FAILURE;
+    }
+    atomic_store_explicit(&g_go, 1, memory_order_release);
+    uint64_t t0 = mono_ns(), c0 = cycles_now();
+    for (uint64_t i = 0; i < writes; ++i) REG32(THRUST) = (uint32_t)i;
+    uint64_t c1 = cycles_now(), t1 = mono_ns();
+    atomic_store(&g_stop, 1);
+    pthread_join(poller, NULL);
+
+    double secs = (double)(t1 - t0) / 1e9;
+    printf("layout            %s (CACHELINE_SIZE %u, sizeof(hw_regs_t) %zu, THRUST@%zu STATUS@%zu)\n",
+           CFG_SPLIT_REGS ? "split" : "packed", (unsigned)CACHELINE_SIZE, sizeof(hw_regs_t),
+           offsetof(hw_regs_t, THRUST), offsetof(hw_regs_t, STATUS));
+    printf("writer cpu %d      %.2f ns/write  (%.1f ticks)\n", wcpu,
+           (double)(t1 - t0) / (double)writes, (double)(c1 - c0) / (double)writes);
+    printf("poller cpu %d      %.1f M polls/s\n", pcpu,
+           secs > 0.0 ? (double)atomic_load(&g_polls) / secs / 1e6 : 0.0);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,263 @@
+/*
+ * Macro vs. static inline vs. _Generic microbenchmarks
+ * ------------------------------------------------------------------
+ * Each demo macro (SQUARE from FUNCTION_TYPE_MACRO.c, SWAP from
+ * MULTIPLE_LINE_MACRO.c, SAFE_CALL, ASSERT and SET_THRUST_N from
+ * NASA_SIMPLE_PROJECT.c) runs in a loop over an int array next to an
+ * equivalent static inline function and, where the macro is type-generic,
+ * a _Generic dispatch. Every kernel is NOINLINE and lives in its own
+ * section, so the reported code size is the exact size of that loop
+ * including any failure path the form drags into it.
+ *
+ * Build and run at each optimisation level:
+ *   for o in 0 2 3; do
+ *     gcc -std=c11 -O$o -DFLIGHT_BUILD -DSIM_HW_REGS -DBENCH_OPT_LABEL='"-O'$o'"' \
+ *         MACRO_INLINE_BENCH.c -o mib_O$o && ./mib_O$o
+ *   done
+ * Repeat with -DGROUND_BUILD to include the LOGF cost of SET_THRUST_N
+ * (stderr goes to /dev/null unless -v is given).
+ *
+ * Options:
+ *   -n <elems>   array length per kernel call (default 4096)
+ *   -t <ms>      target time per measurement (default 50); best of 5
+ *   -v           keep LOGF output on stderr
+ *
+ * The inline forms keep the macros' behaviour (same format strings, same
+ * abort/exit), but they lose per-call-site state: #call and __func__ name
+ * the helper, not the caller, and SET_THRUST_N's LOGF_EVERY_MS limiter is
+ * shared by every caller of set_thrust_n().
+ */
+
+#define NASA_NO_MAIN
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "NASA_SIMPLE_PROJECT.c"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifndef SIM_HW_REGS
+#  error "MACRO_INLINE_BENCH.c writes THRUST through the simulated registers: build with -DSIM_HW_REGS"
+#endif
+
+#ifndef BENCH_OPT_LABEL
+#  ifdef __OPTIMIZE__
+#    define BENCH_OPT_LABEL "optimized"
+#  else
+#    define BENCH_OPT_LABEL "-O0"
+#  endif
+#endif
+
+/* --- the forms under test ------------------------------------------ */
+
+#define SQUARE(x) ((x) * (x))
+static inline int      square_i(int x)      { return x * x; }
+static inline unsigned square_u(unsigned x) { return x * x; }
+static inline double   square_d(double x)   { return x * x; }
+#define SQUARE_G(x) _Generic((x), int: square_i, unsigned: square_u, double: square_d)(x)
+
+/* SWAP: the type-generic one from section 5 of NASA_SIMPLE_PROJECT.c */
+static inline void swap_int(int *a, int *b)       { int t = *a; *a = *b; *b = t; }
+static inline void swap_dbl(double *a, double *b) { double t = *a; *a = *b; *b = t; }
+#define SWAP_G(a, b) _Generic(*(a), int: swap_int, double: swap_dbl)((a), (b))
+
+static inline int step_ok(int v) { return v < 0 ? ERR_SENSOR_FAIL : 0; }
+
+static inline void safe_call_check(int rc, const char *expr) {
+    (void)expr;                                  /* unused when LOGF is compiled out */
+    if (UNLIKELY(rc != 0)) {
+        LOGF(SAFE_CALL_FMT, expr, rc);
+        LOG_SINK_FLUSH();
+        exit(EXIT_FAILURE);
+    }
+}
+
+static inline void assert_check(int ok, const char *expr) {
+#if CFG_ENABLE_ASSERTS
+    if (UNLIKELY(!ok)) {
+        LOGF(ASSERT_FMT, expr);
+        LOG_SINK_FLUSH();
+        abort();
+    }
+#endif
+    (void)ok;
+    (void)expr;
+}
+
+static inline void set_thrust_n(uint32_t n) {
+    LOGF_EVERY_MS(n > CFG_MAX_THRUST_N, LOG_CAP_INTERVAL_MS,
+                  "Thrust request %u exceeds limit %u — capping", n, (unsigned)CFG_MAX_THRUST_N);
+    if (UNLIKELY(n > CFG_MAX_THRUST_N)) n = CFG_MAX_THRUST_N;
+    REG_PUT(THRUST, n);
+    LOGF("THRUST set to %u N", n);
+}
+
+/* --- kernels --------------------------------------------------------- */
+
+/* X(group, form, kernel) */
+#define BENCH_TABLE \
+    X(SQUARE,       macro,    sq_macro)  \
+    X(SQUARE,       inline,   sq_inline) \
+    X(SQUARE,       _Generic, sq_generic) \
+    X(SWAP,         macro,    sw_macro)  \
+    X(SWAP,         inline,   sw_inline) \
+    X(SWAP,         _Generic, sw_generic) \
+    X(SAFE_CALL,    macro,    sc_macro)  \
+    X(SAFE_CALL,    inline,   sc_inline) \
+    X(ASSERT,       macro,    as_macro)  \
+    X(ASSERT,       inline,   as_inline) \
+    X(SET_THRUST_N, macro,    th_macro)  \
+    X(SET_THRUST_N, inline,   th_inline)
+
+#define BENCH_KERNEL(k) \
+    extern const char __start_mib_##k[], __stop_mib_##k[]; \
+    static NOINLINE __attribute__((section("mib_" #k))) uint64_t k(int *a, size_t n)
+
+BENCH_KERNEL(sq_macro)   { uint64_t s = 0; for (size_t i = 0; i < n; ++i) s += (uint64_t)SQUARE(a[i]);   return s; }
+BENCH_KERNEL(sq_inline)  { uint64_t s = 0; for (size_t i = 0; i < n; ++i) s += (uint64_t)square_i(a[i]); return s; }
+BENCH_KERNEL(sq_generic) { uint64_t s = 0; for (size_t i = 0; i < n; ++i) s += (uint64_t)SQUARE_G(a[i]); return s; }
+
+BENCH_KERNEL(sw_macro)   { for (size_t i = 0; i < n / 2; ++i) SWAP(a[i], a[n - 1 - i]);        return (uint64_t)a[0]; }
+BENCH_KERNEL(sw_inline)  { for (size_t i = 0; i < n / 2; ++i) swap_int(&a[i], &a[n - 1 - i]); return (uint64_t)a[0]; }
+BENCH_KERNEL(sw_generic) { for (size_t i = 0; i < n / 2; ++i) SWAP_G(&a[i], &a[n - 1 - i]);   return (uint64_t)a[0]; }
+
+BENCH_KERNEL(sc_macro) {
+    uint64_t s = 0;
+    for (size_t i = 0; i < n; ++i) { SAFE_CALL(step_ok(a[i])); s += (uint64_t)a[i]; }
+    return s;
+}
+BENCH_KERNEL(sc_inline) {
+    uint64_t s = 0;
+    for (size_t i = 0; i < n; ++i) { safe_call_check(step_ok(a[i]), "step_ok(a[i])"); s += (uint64_t)a[i]; }
+    return s;
+}
+
+BENCH_KERNEL(as_macro) {
+    uint64_t s = 0;
+    for (size_t i = 0; i < n; ++i) { ASSERT(a[i] >= 0); s += (uint64_t)a[i]; }
+    return s;
+}
+BENCH_KERNEL(as_inline) {
+    uint64_t s = 0;
+    for (size_t i = 0; i < n; ++i) { assert_check(a[i] >= 0, "a[i] >= 0"); s += (uint64_t)a[i]; }
+    return s;
+}
+
+/* Values run 0..8190, so roughly half of the requests hit the cap */
+BENCH_KERNEL(th_macro)  { for (size_t i = 0; i < n; ++i) SET_THRUST_N(a[i] * 2);           return REG_GET(THRUST); }
+BENCH_KERNEL(th_inline) { for (size_t i = 0; i < n; ++i) set_thrust_n((uint32_t)a[i] * 2u); return REG_GET(THRUST); }
+
+/* --- driver ---------------------------------------------------------- */
+
+typedef uint64_t (*bench_fn)(int *, size_t);
+
+typedef struct {
+    const char *group;
+    const char *form;
+    bench_fn    fn;
+} bench_t;
+
+static const bench_t g_bench[] = {
+#define X(group, form, k) { #group, #form, k },
+    BENCH_TABLE
+#undef X
+};
+
+static size_t bench_code_bytes(unsigned i) {
+    const size_t sizes[] = {      /* section bounds are link-time, not constant */
+#define X(group, form, k) (size_t)(__stop_mib_##k - __start_mib_##k),
+        BENCH_TABLE
+#undef X
+    };
+    return sizes[i];
+}
+
+static volatile uint64_t g_result;
+
+/* Best-of-5 ns and ticks per element, each trial lasting about target_ns */
+static void bench_run(const bench_t *b, int *a, size_t n, uint64_t target_ns,
+                      double *ns_op, double *ticks_op) {
+    uint64_t reps = 1;
+    for (;;) {                                   /* calibrate; also warms up */
+        uint64_t t0 = mono_ns();
+        for (uint64_t r = 0; r < reps; ++r) g_result += b->fn(a, n);
+        uint64_t dt = mono_ns() - t0;
+        if (dt >= target_ns / 4u || reps >= (1ull << 40)) {
+            reps = dt ? reps * target_ns / dt + 1u : reps * 2u;
+            break;
+        }
+        reps *= 2u;
+    }
+    *ns_op = *ticks_op = 0.0;
+    for (int trial = 0; trial < 5; ++trial) {
+        uint64_t t0 = mono_ns(), c0 = cycles_now();
+        for (uint64_t r = 0; r < reps; ++r) g_result += b->fn(a, n);
+        uint64_t c1 = cycles_now(), t1 = mono_ns();
+        double ops = (double)reps * (double)n;
+        double ns  = (double)(t1 - t0) / ops, ticks = (double)(c1 - c0) / ops;
+        if (trial == 0 || ns < *ns_op) { *ns_op = ns; *ticks_op = ticks; }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t   n = 4096;
+    uint64_t target_ms = 50;
+    int verbose = 0, opt;
+    while ((opt = getopt(argc, argv, "n:t:v")) != -1) {
+        switch (opt) {
+        case 'n': n = (size_t)strtoull(optarg, NULL, 10); break;
+        case 't': target_ms = strtoull(optarg, NULL, 10); break;
+        case 'v': verbose = 1; break;
+        default:
+            fprintf(stderr, "usage: %s [-n elems] [-t ms] [-v]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (n < 2) n = 2;
+    if (target_ms == 0) target_ms = 1;
+
+    int *a = malloc(n * sizeof *a);
+    if (!a) { perror("malloc"); return EXIT_FAILURE; }
+    uint32_t lcg = 12345u;
+    for (size_t i = 0; i < n; ++i) {
+        lcg = lcg * 1664525u + 1013904223u;
+        a[i] = (int)(lcg >> 20);                 /* 0..4095: no SQUARE overflow */
+    }
+
+    int saved_stderr = -1;
+    if (!verbose) {
+        int devnull = open("/dev/null", O_WRONLY);
+        fflush(stderr);
+        saved_stderr = dup(STDERR_FILENO);
+        if (devnull >= 0) { dup2(devnull, STDERR_FILENO); close(devnull); }
+    }
+
+    enum { NBENCH = sizeof g_bench / sizeof g_bench[0] };
+    double ns[NBENCH], ticks[NBENCH];
+    for (unsigned i = 0; i < NBENCH; ++i) {
+        bench_run(&g_bench[i], a, n, target_ms * 1000000u, &ns[i], &ticks[i]);
+    }
+
+    if (saved_stderr >= 0) {
+        LOG_SINK_FLUSH();
+        fflush(stderr);
+        dup2(saved_stderr, STDERR_FILENO);
+        close(saved_stderr);
+    }
+
+    printf("macro vs inline: %s, %s, logs=%d, asserts=%d, outline=%d, n=%zu\n",
+#if defined(FLIGHT_BUILD)
+           "FLIGHT_BUILD",
+#else
+           "GROUND_BUILD",
+#endif
+           BENCH_OPT_LABEL, CFG_ENABLE_LOGS, CFG_ENABLE_ASSERTS, CFG_OUTLINE_FAILURES, n);
+    printf("%-13s %-9s %10s %10s %11s\n", "pattern", "form", "ns/op", "ticks/op", "code bytes");
+    for (unsigned i = 0; i < NBENCH; ++i) {
+        const bench_t *b = &g_bench[i];
+        int first = i == 0 || strcmp(b->group, g_bench[i - 1].group) != 0;
+        printf("%-13s %-9s %10.3f %10.2f %11zu\n", first ? b->group : "", b->form,
+               ns[i], ticks[i], bench_code_bytes(i));
+    }
+    free(a);
+    return EXIT_SUCCESS;
+}
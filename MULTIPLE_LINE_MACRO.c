@@ -1,11 +1,28 @@
 #include <stdio.h>
+#include <string.h>
 
+/* Type-generic: the temporary takes the type of a (GCC/Clang __typeof__);
+ * elsewhere the bytes go through a buffer of sizeof(a). */
+#if defined(__GNUC__) || defined(__clang__)
 #define SWAP(a, b) \
     do {           \
-        int temp = a; \
-        a = b;     \
-        b = temp;  \
+        _Static_assert(__builtin_types_compatible_p(__typeof__(a), __typeof__(b)), \
+                       "SWAP needs two objects of the same type"); \
+        __typeof__(a) temp = (a); \
+        (a) = (b); \
+        (b) = temp; \
     } while (0)
+#else
+#define SWAP(a, b) \
+    do {           \
+        unsigned char temp[sizeof(a) == sizeof(b) ? sizeof(a) : -1]; \
+        memcpy(temp, &(a), sizeof temp); \
+        memcpy(&(a), &(b), sizeof temp); \
+        memcpy(&(b), temp, sizeof temp); \
+    } while (0)
+#endif
+
+struct point { int x, y; };
 
 int main() {
     int x = 5, y = 10;
@@ -16,5 +33,13 @@ int main() {
 
     printf("After swap:  x=%d, y=%d\n", x, y);
 
+    double d1 = 1.5, d2 = -2.25;
+    SWAP(d1, d2); // same macro, no truncation to int
+    printf("Doubles:     d1=%g, d2=%g\n", d1, d2);
+
+    struct point p = { 1, 2 }, q = { 3, 4 };
+    SWAP(p, q); // whole structs
+    printf("Structs:     p=(%d,%d), q=(%d,%d)\n", p.x, p.y, q.x, q.y);
+
     return 0;
 }
@@ -0,0 +1,143 @@
+/*
+ * Offline decoder for the CFG_LOG_BINARY backend of NASA_SIMPLE_PROJECT.c
+ * ------------------------------------------------------------------
+ * Reads the dump written at exit (CFG_LOG_BINARY_PATH) and prints the
+ * same "[LOG] file:line func(): ..." / "[TRACE] ..." lines the text
+ * backend would have written to stderr, in record order.
+ *
+ * Build (use the same config flags as the producing binary):
+ *   gcc -std=c11 -O2 -DGROUND_BUILD -DSIM_HW_REGS -DCFG_LOG_BINARY=1 NASA_LOG_DECODER.c -o nasa_logdec
+ *
+ * Run:
+ *   ./nasa_logdec [-t] nasa_log.bin     (-t prefixes each line with its tick stamp)
+ */
+
+#define NASA_NO_MAIN
+#define CFG_LOG_BINARY 1
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "NASA_SIMPLE_PROJECT.c"
+
+#if !(CFG_ENABLE_LOGS && CFG_LOG_BINARY)
+#  error "NASA_LOG_DECODER.c needs a build with logs enabled (GROUND_BUILD)"
+#endif
+
+typedef struct {
+    uint16_t kind;
+    uint32_t line;
+    char    *file;
+    char    *func;
+    char    *fmt;
+} dec_site_t;
+
+static dec_site_t sites[SITE_MAX + 1u];        /* by registry ID; 0 is unused */
+
+static int get(FILE *f, void *dst, size_t n) { return fread(dst, 1, n, f) == n ? 0 : -1; }
+
+static char *get_str(FILE *f) {
+    uint16_t n = 0;
+    if (get(f, &n, sizeof n) != 0) return NULL;
+    char *s = malloc((size_t)n + 1u);
+    if (!s) return NULL;
+    if (n && get(f, s, n) != 0) { free(s); return NULL; }
+    s[n] = '\0';
+    return s;
+}
+
+/* Format one argument word according to a single printf conversion spec. */
+static void put_arg(const char *spec, char conv, uint64_t w, const char *str) {
+    const char *len = spec + strcspn(spec, "hljztL");
+    int ll = !strncmp(len, "ll", 2), l = !ll && *len == 'l';
+    int z  = *len == 'z' || *len == 't' || *len == 'j';
+    switch (conv) {
+    case 'd': case 'i': case 'c':
+        if (ll)     printf(spec, (long long)w);
+        else if (l) printf(spec, (long)w);
+        else if (z) printf(spec, (ptrdiff_t)w);
+        else        printf(spec, (int)w);
+        break;
+    case 'o': case 'u': case 'x': case 'X':
+        if (ll)     printf(spec, (unsigned long long)w);
+        else if (l) printf(spec, (unsigned long)w);
+        else if (z) printf(spec, (size_t)w);
+        else        printf(spec, (unsigned)w);
+        break;
+    case 'p': printf(spec, (void *)(uintptr_t)w); break;
+    case 's': printf(spec, str ? str : "(null)"); break;
+    default:  break; /* %n is never replayed */
+    }
+}
+
+static int decode(FILE *f, int show_ts) {
+    char magic[4];
+    uint32_t ver = 0, nsites = 0;
+    uint64_t nrecs = 0, lost = 0;
+    if (get(f, magic, 4) || memcmp(magic, "NLOG", 4) || get(f, &ver, sizeof ver) ||
+        ver != LOG_DUMP_VERSION || get(f, &nsites, sizeof nsites) ||
+        get(f, &nrecs, sizeof nrecs) || get(f, &lost, sizeof lost)) {
+        fprintf(stderr, "not a version %u NLOG dump\n", LOG_DUMP_VERSION);
+        return -1;
+    }
+    for (uint32_t i = 0; i < nsites; ++i) {
+        uint16_t id = 0, kind = 0;
+        uint32_t line = 0;
+        if (get(f, &id, sizeof id) || get(f, &kind, sizeof kind) ||
+            get(f, &line, sizeof line) || id == 0) return -1;
+        sites[id].kind = kind;
+        sites[id].line = line;
+        sites[id].file = get_str(f);
+        sites[id].func = get_str(f);
+        sites[id].fmt  = get_str(f);
+        if (!sites[id].file || !sites[id].func || !sites[id].fmt) return -1;
+    }
+    if (lost) fprintf(stderr, "[LOGDEC] %llu records lost to ring wrap\n", (unsigned long long)lost);
+
+    for (uint64_t r = 0; r < nrecs; ++r) {
+        uint64_t ts = 0;
+        uint16_t id = 0, nargs = 0;
+        if (get(f, &ts, sizeof ts) || get(f, &id, sizeof id) || get(f, &nargs, sizeof nargs) ||
+            id == 0 || !sites[id].fmt || nargs > LOG_MAX_ARGS) return -1;
+        const dec_site_t *s = &sites[id];
+        if (show_ts) printf("%llu ", (unsigned long long)ts);
+        if (s->kind == LOG_KIND_TRACE) {
+            printf("[TRACE] %s:%u in %s()\n", s->file, (unsigned)s->line, s->func);
+            continue;
+        }
+        printf("[LOG] %s:%u %s(): ", s->file, (unsigned)s->line, s->func);
+        const char *p = s->fmt, *lit = p;
+        char spec[32], conv = 0;
+        unsigned used = 0;
+        while ((p = log_fmt_next(lit, spec, sizeof spec, &conv)) != NULL) {
+            fwrite(lit, 1, (size_t)(strchr(lit, '%') - lit), stdout);
+            lit = p;
+            if (conv == '%') { putchar('%'); continue; }
+            if (used >= nargs) break;
+            ++used;
+            uint64_t w = 0;
+            char *str = NULL;
+            if (conv == 's') { if (!(str = get_str(f))) return -1; }
+            else if (get(f, &w, sizeof w)) return -1;
+            put_arg(spec, conv, w, str);
+            free(str);
+        }
+        for (uint64_t w = 0; used < nargs; ++used) {
+            if (get(f, &w, sizeof w)) return -1; /* surplus args: not in fmt */
+        }
+        fputs(lit, stdout);
+        putchar('\n');
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    int show_ts = argc > 2 && !strcmp(argv[1], "-t");
+    if (argc != 2 + show_ts) {
+        fprintf(stderr, "usage: %s [-t] <dump.bin>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    FILE *f = fopen(argv[1 + show_ts], "rb");
+    if (!f) { perror(argv[1 + show_ts]); return EXIT_FAILURE; }
+    int rc = decode(f, show_ts);
+    fclose(f);
+    if (rc != 0) { fprintf(stderr, "corrupt dump: %s\n", argv[1 + show_ts]); return EXIT_FAILURE; }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+/*
+ * Live metrics reader for NASA_SIMPLE_PROJECT.c
+ * ------------------------------------------------------------------
+ * Maps the metrics block a running control process publishes
+ * (CFG_METRICS_SHM, section 4b) read-only and samples it: loop rate,
+ * cap events, deadline misses, error counts and the control-tick latency
+ * histogram. The process being watched makes no syscall and formats
+ * nothing for this; all the work is here.
+ *
+ * Build with the same CFG_METRICS_SHM_NAME as the process:
+ *   gcc -std=c11 -O2 -DGROUND_BUILD -DSIM_HW_REGS -DCFG_METRICS_SHM=1 \
+ *       NASA_METRICS_READER.c -o nasa_metrics
+ *   ./nasa_macro & ./nasa_metrics -i 500 -n 8
+ *
+ * Options:
+ *   -i <ms>   sample interval (default 1000)
+ *   -n <N>    samples, 0 = until interrupted (default 0)
+ *   -u        unlink the block after the last sample
+ */
+
+#define NASA_NO_MAIN
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "NASA_SIMPLE_PROJECT.c"
+
+#include <signal.h>
+#include <sys/stat.h>
+
+#if !CFG_METRICS_SHM || !(defined(__GNUC__) || defined(__clang__))
+#  error "NASA_METRICS_READER.c needs the metrics block: build with -DCFG_METRICS_SHM=1"
+#endif
+
+#define LOAD(field) atomic_load_explicit(&(field), memory_order_relaxed)
+
+static const metrics_block_t *metrics_map(void) {
+    int fd = shm_open(CFG_METRICS_SHM_NAME, O_RDONLY, 0);
+    if (fd < 0) { perror("shm_open " CFG_METRICS_SHM_NAME); return NULL; }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(metrics_block_t)) {
+        fprintf(stderr, "%s: too small for a metrics block\n", CFG_METRICS_SHM_NAME);
+        close(fd);
+        return NULL;
+    }
+    void *p = mmap(NULL, sizeof(metrics_block_t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) { perror("mmap"); return NULL; }
+    const metrics_block_t *m = p;
+    if (m->magic != METRICS_MAGIC) {
+        fprintf(stderr, "%s: no metrics block (magic %08x)\n", CFG_METRICS_SHM_NAME, (unsigned)m->magic);
+        return NULL;
+    }
+    atomic_thread_fence(memory_order_acquire);
+    if (m->version != METRICS_VERSION || m->size != sizeof *m || m->err_slots > METRICS_ERR_SLOTS) {
+        fprintf(stderr, "%s: version %u / %u bytes, reader is %u / %zu bytes\n", CFG_METRICS_SHM_NAME,
+                (unsigned)m->version, (unsigned)m->size, METRICS_VERSION, sizeof *m);
+        return NULL;
+    }
+    return m;
+}
+
+/* Upper edge of the bucket holding quantile p, in ticks */
+static uint64_t lat_percentile(const uint64_t *hist, uint64_t n, double p) {
+    uint64_t want = (uint64_t)(p * (double)n), seen = 0;
+    for (unsigned b = 0; b < METRICS_LAT_BUCKETS; ++b) {
+        seen += hist[b];
+        if (seen > want) return 2ull << b;
+    }
+    return 2ull << (METRICS_LAT_BUCKETS - 1u);
+}
+
+static void print_sample(const metrics_block_t *m, uint64_t *prev_it, uint64_t *prev_ns) {
+    uint64_t now = mono_ns();
+    uint64_t it  = LOAD(m->iterations);
+    uint64_t cns = LOAD(m->clock_ns), ctk = LOAD(m->clock_ticks);
+    uint64_t hist[METRICS_LAT_BUCKETS], n = 0;
+    for (unsigned b = 0; b < METRICS_LAT_BUCKETS; ++b) n += hist[b] = LOAD(m->lat_hist[b]);
+
+    /* Tick length from the loop's own clock pairs; unknown until the first one */
+    double ns_per_tick = ctk > m->t0_ticks ? (double)(cns - m->t0_ns) / (double)(ctk - m->t0_ticks) : 0.0;
+    int alive = kill((pid_t)m->pid, 0) == 0;
+
+    printf("pid %llu %s  heartbeat %.1f ms ago\n", (unsigned long long)m->pid,
+           alive ? "alive" : "stale", (double)(now - cns) / 1e6);
+    printf("iterations   %llu  (%.0f/s)\n", (unsigned long long)it,
+           *prev_ns ? (double)(it - *prev_it) * 1e9 / (double)(now - *prev_ns) : 0.0);
+    printf("cap events   %llu\n", (unsigned long long)LOAD(m->cap_events));
+    printf("deadline     %llu missed\n", (unsigned long long)LOAD(m->deadline_misses));
+    for (unsigned i = 0; i < m->err_slots; ++i) {
+        uint64_t c = LOAD(m->errors[i]);
+        if (c) printf("error        %-*.*s %llu\n", (int)METRICS_NAME_LEN, (int)METRICS_NAME_LEN,
+                      m->err_name[i], (unsigned long long)c);
+    }
+    if (n) {
+        static const double q[] = { 0.50, 0.99, 0.999 };
+        printf("tick latency");
+        for (unsigned k = 0; k < sizeof q / sizeof q[0]; ++k) {
+            uint64_t t = lat_percentile(hist, n, q[k]);
+            if (ns_per_tick > 0.0) printf("  p%g <%.0f ns", q[k] * 100.0, (double)t * ns_per_tick);
+            else                   printf("  p%g <%llu ticks", q[k] * 100.0, (unsigned long long)t);
+        }
+        printf("\n");
+        for (unsigned b = 0; b < METRICS_LAT_BUCKETS; ++b) {
+            if (!hist[b]) continue;
+            printf("  < %10.0f %s %12llu  %5.1f%%\n",
+                   ns_per_tick > 0.0 ? (double)(2ull << b) * ns_per_tick : (double)(2ull << b),
+                   ns_per_tick > 0.0 ? "ns   " : "ticks", (unsigned long long)hist[b],
+                   100.0 * (double)hist[b] / (double)n);
+        }
+    }
+    printf("\n");
+    fflush(stdout);
+    *prev_it = it;
+    *prev_ns = now;
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t interval_ms = 1000, samples = 0;
+    int unlink_after = 0, opt;
+    while ((opt = getopt(argc, argv, "i:n:u")) != -1) {
+        switch (opt) {
+        case 'i': interval_ms = strtoull(optarg, NULL, 10); break;
+        case 'n': samples = strtoull(optarg, NULL, 10); break;
+        case 'u': unlink_after = 1; break;
+        default:
+            fprintf(stderr, "usage: %s [-i ms] [-n samples] [-u]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (interval_ms == 0) interval_ms = 1;
+
+    const metrics_block_t *m = metrics_map();
+    if (!m) return EXIT_FAILURE;
+
+    uint64_t prev_it = 0, prev_ns = 0;
+    for (uint64_t s = 0; samples == 0 || s < samples; ++s) {
+        if (s) {
+            struct timespec ts = { (time_t)(interval_ms / 1000u), (long)(interval_ms % 1000u) * 1000000L };
+            nanosleep(&ts, NULL);
+        }
+        print_sample(m, &prev_it, &prev_ns);
+    }
+    if (unlink_after && shm_unlink(CFG_METRICS_SHM_NAME) != 0) {
+        perror("shm_unlink " CFG_METRICS_SHM_NAME);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -13,19 +13,110 @@
  *   Flight (optimized, no debug logs):
  *     gcc -std=c11 -O2 -DNDEBUG -DFLIGHT_BUILD -DSIM_HW_REGS nasa_macro.c -o nasa_macro
  *
+ *   Real registers (no SIM_HW_REGS: the device window is mmap'ed at init):
+ *     gcc -std=c11 -O2 -DNDEBUG -DFLIGHT_BUILD -DCFG_HW_DEV='"/dev/uio0"' nasa_macro.c -o nasa_macro
+ *
  *   Architecture switch (choose exactly one):
  *     -DCPU_ARM   or   -DCPU_RISCV
  *
+ *   Deferred-format binary logging (ground builds; decode offline):
+ *     gcc -std=c11 -O2 -DGROUND_BUILD -DSIM_HW_REGS -DCFG_LOG_BINARY=1 nasa_macro.c -o nasa_macro
+ *     gcc -std=c11 -O2 -DGROUND_BUILD -DSIM_HW_REGS -DCFG_LOG_BINARY=1 NASA_LOG_DECODER.c -o nasa_logdec
+ *     ./nasa_macro && ./nasa_logdec nasa_log.bin
+ *
+ *   Asynchronous text logs (lock-free ring + batched writev on a sink thread):
+ *     gcc -std=c11 -O2 -DGROUND_BUILD -DSIM_HW_REGS -DCFG_LOG_ASYNC=1 -pthread nasa_macro.c -o nasa_macro
+ *
+ *   Ring-buffer tracing (enter/exit events -> Chrome trace / Perfetto JSON):
+ *     gcc -std=c11 -O2 -DGROUND_BUILD -DSIM_HW_REGS -DCFG_TRACE_RING=1 nasa_macro.c -o nasa_macro
+ *     ./nasa_macro   # writes nasa_trace.json; open in ui.perfetto.dev
+ *
+ *   Per-site cycle profiles ([PROF] report at exit; ground builds):
+ *     on by default with logs; add -DCFG_PROFILE=0 to drop PROFILE_SCOPE
+ *
+ *   Branch-hint check (LIKELY/UNLIKELY vs. real traffic; [BRANCH] report at exit):
+ *     add -DCFG_BRANCH_PROFILE=1 to either build; all sites go to nasa_branch.csv
+ *
+ *   Shadow registers (skip unchanged writes, one burst per tick):
+ *     add -DCFG_SHADOW_REGS=1 to either build
+ *
+ *   Asynchronous actuator commands (queued, acknowledged through STATUS):
+ *     add -DCFG_ACT_PIPELINE=1 to either build
+ *
+ *   Calibrated sensor (raw ADC counts -> degC via compile-time LUT):
+ *     add -DCFG_TEMP_CAL=1 to either build
+ *
+ *   Sensor acquisition thread + SPSC sample ring (control never waits on the bus):
+ *     add -DCFG_SENSOR_ACQ=1 -pthread to either build
+ *
+ *   Event-driven sensor reads (spin, then sleep until the next sample):
+ *     add -DCFG_SENSOR_WAIT=1 -pthread to either build; see SENSOR_WAIT_BENCH.c
+ *
+ *   Telemetry downlink (delta/bit-packed frames of the register file):
+ *     gcc -std=c11 -O2 -DGROUND_BUILD -DSIM_HW_REGS -DCFG_TLM_DOWNLINK=1 nasa_macro.c -o nasa_macro
+ *     gcc -std=c11 -O2 -DGROUND_BUILD -DSIM_HW_REGS NASA_TLM_DECODER.c -o nasa_tlmdec
+ *     ./nasa_macro && ./nasa_tlmdec nasa_tlm.bin
+ *
+ *   Specialized control loop for one profile of the section 10b table:
+ *     add -DCFG_CONTROL_PROFILE='"derated"' to either build
+ *
+ *   Multi-rate scheduler demo (control/temp/telemetry for 200 ms):
+ *     add -DCFG_SCHED_DEMO_MS=200 to either build
+ *
+ *   Monte Carlo farm (N simulated vehicles per process, one thread per core):
+ *     gcc -std=c11 -O2 -DFLIGHT_BUILD -DSIM_HW_REGS -pthread SIM_FARM.c -o nasa_farm
+ *
+ *   Bulk endian conversion of register dumps (BSWAP_BUFFER, section 5c):
+ *     gcc -std=c11 -O2 -DFLIGHT_BUILD -DSIM_HW_REGS -mavx2 BSWAP_BENCH.c -o nasa_bswap
+ *
+ *   Live metrics in shared memory (sampled by a separate reader, no syscalls on the loop):
+ *     gcc -std=c11 -O2 -DGROUND_BUILD -DSIM_HW_REGS -DCFG_METRICS_SHM=1 -DCFG_SCHED_DEMO_MS=5000 nasa_macro.c -o nasa_macro
+ *     gcc -std=c11 -O2 -DGROUND_BUILD -DSIM_HW_REGS -DCFG_METRICS_SHM=1 NASA_METRICS_READER.c -o nasa_metrics
+ *     ./nasa_macro & ./nasa_metrics -i 500 -n 8
+ *
+ *   Warm restart (state of the last valid tick kept in a mapped file; start-up timing):
+ *     add -DCFG_WARM_START=1 to either build; see COLD_START_BENCH.c
+ *
+ *   Embedding (tools/benchmarks that reuse this unit):
+ *     #define NASA_NO_MAIN before #include "NASA_SIMPLE_PROJECT.c"
+ *
  * Run:
  *   ./nasa_macro
  */
 
+#if !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+#  if defined(__linux__)
+#    define _GNU_SOURCE            /* POSIX + CPU affinity under -std=c11 */
+#  else
+#    define _POSIX_C_SOURCE 200809L /* clock_gettime & co. under -std=c11 */
+#  endif
+#endif
+
+/* glibc's <errno.h> also declares an error_t under _GNU_SOURCE; its
+ * guard keeps section 8's */
+#define __error_t_defined 1
+#include <errno.h>
 #include <stdio.h>
+#include <stdatomic.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
+/* Vector intrinsics of the compiler's target ISA (sections 5c, 7 and 10) */
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#elif defined(__SSSE3__)
+#  include <tmmintrin.h>
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#  include <arm_neon.h>
+#elif defined(__riscv_vector)
+#  include <riscv_vector.h>
+#endif
+
 /* ------------------------------------------------------------------
  * 0) Safety: mutually-exclusive build types and arch selection
  * ------------------------------------------------------------------ */
@@ -55,6 +146,191 @@
 #  define CFG_MAX_THRUST_N     4000
 #endif
 
+/* Actuator channels handled by the batched engine (section 10) */
+#ifndef CFG_THRUSTER_CHANNELS
+#  define CFG_THRUSTER_CHANNELS 16
+#endif
+#if CFG_THRUSTER_CHANNELS < 1 || CFG_THRUSTER_CHANNELS > 64
+#  error "CFG_THRUSTER_CHANNELS must be 1..64 (capping mask is one uint64_t)"
+#endif
+
+/* Control loop main() and the scheduler run (section 10b): "generic" is the
+ * instrumented run_control_loop_once(), any CONTROL_PROFILE_TABLE row name
+ * selects that row's specialized copy */
+#ifndef CFG_CONTROL_PROFILE
+#  define CFG_CONTROL_PROFILE  "generic"
+#endif
+
+/* Real register window (section 6, builds without SIM_HW_REGS): device
+ * node and byte offset of CTRL in it (UIO map N: N * page size) */
+#ifndef CFG_HW_DEV
+#  define CFG_HW_DEV           "/dev/uio0"
+#endif
+#ifndef CFG_HW_MAP_OFFSET
+#  define CFG_HW_MAP_OFFSET    0
+#endif
+
+/* Simulated register file layout (section 6): 1 = each register on its
+ * own cache line, so a writer of THRUST doesn't bounce a STATUS poller */
+#ifndef CFG_SPLIT_REGS
+#  define CFG_SPLIT_REGS       0
+#endif
+
+/* Shadow-register write coalescing for CTRL/THRUST (section 6) */
+#ifndef CFG_SHADOW_REGS
+#  define CFG_SHADOW_REGS      0
+#endif
+
+/* Actuator command pipeline (section 7c): 1 = command_thrust() queues and
+ * the tick issues/retires commands on STATUS acknowledgements */
+#ifndef CFG_ACT_PIPELINE
+#  define CFG_ACT_PIPELINE     0
+#endif
+#ifndef CFG_ACT_INFLIGHT
+#  define CFG_ACT_INFLIGHT     4          /* unacknowledged commands at most */
+#endif
+#ifndef CFG_ACT_ACK_TIMEOUT_NS
+#  define CFG_ACT_ACK_TIMEOUT_NS 10000000u
+#endif
+#ifndef CFG_SIM_ACT_LATENCY_NS
+#  define CFG_SIM_ACT_LATENCY_NS 200000u  /* simulated doorbell -> ack */
+#endif
+#if CFG_ACT_INFLIGHT < 1 || CFG_ACT_INFLIGHT > 64
+#  error "CFG_ACT_INFLIGHT must be 1..64 (8-bit command sequence numbers)"
+#endif
+
+/* Temperature calibration behind READ_TEMP_RAW (section 7): cubic curve
+ * degC = C0 + C1*raw + C2*raw^2 + C3*raw^3 over a 12-bit ADC range */
+#ifndef CFG_TEMP_CAL
+#  define CFG_TEMP_CAL         0   /* 0 = raw is already degC (demo sensor) */
+#endif
+#ifndef CFG_TEMP_CAL_C0
+#  define CFG_TEMP_CAL_C0      125.0
+#  define CFG_TEMP_CAL_C1      (-0.08)
+#  define CFG_TEMP_CAL_C2      1.0e-5
+#  define CFG_TEMP_CAL_C3      (-1.2e-9)
+#endif
+
+/* Sensor acquisition on its own thread feeding an SPSC ring (section 7b) */
+#ifndef CFG_SENSOR_ACQ
+#  define CFG_SENSOR_ACQ       0
+#endif
+#ifndef CFG_ACQ_PERIOD_NS
+#  define CFG_ACQ_PERIOD_NS    100000u  /* 10 kHz sampling */
+#endif
+#ifndef CFG_ACQ_CPU
+#  define CFG_ACQ_CPU          (-1)     /* core to pin to; -1 = don't pin */
+#endif
+#ifndef CFG_ACQ_MAX_STALE_TICKS
+#  define CFG_ACQ_MAX_STALE_TICKS 100u  /* ticks without a new sample -> fail */
+#endif
+
+/* Event-driven sensor reads (section 7): 1 = wait for the sensor's
+ * "new sample" interrupt instead of re-reading SENS_TEMP every pass.
+ * Spin for CFG_SENSOR_SPIN_NS, then sleep (futex / UIO); no sample within
+ * CFG_SENSOR_WAIT_TIMEOUT_NS is a sensor failure. Needs -pthread with
+ * SIM_HW_REGS (main() runs a simulated ADC at CFG_ACQ_PERIOD_NS). */
+#ifndef CFG_SENSOR_WAIT
+#  define CFG_SENSOR_WAIT      0
+#endif
+#ifndef CFG_SENSOR_SPIN_NS
+#  define CFG_SENSOR_SPIN_NS   20000u    /* 0 = block at once */
+#endif
+#ifndef CFG_SENSOR_WAIT_TIMEOUT_NS
+#  define CFG_SENSOR_WAIT_TIMEOUT_NS 10000000u
+#endif
+#ifndef CFG_SENSOR_UIO_DEV
+#  define CFG_SENSOR_UIO_DEV   "/dev/uio0"  /* real registers: interrupt fd */
+#endif
+
+/* SAFE_CALL/ASSERT failures: 1 = shared cold handler, 0 = inline (section 5) */
+#ifndef CFG_OUTLINE_FAILURES
+#  define CFG_OUTLINE_FAILURES 1
+#endif
+
+/* LIKELY/UNLIKELY verification: per-site taken counts, wrong hints
+ * reported at exit (section 3; instrumented builds, GCC/clang only) */
+#ifndef CFG_BRANCH_PROFILE
+#  define CFG_BRANCH_PROFILE   0
+#endif
+#ifndef CFG_BRANCH_PROFILE_PATH
+#  define CFG_BRANCH_PROFILE_PATH "nasa_branch.csv"
+#endif
+
+/* PROFILE_SCOPE cycle counters per call site (section 4; ground builds only) */
+#ifndef CFG_PROFILE
+#  define CFG_PROFILE          1
+#endif
+
+/* Static pools/arenas (section 5b): high-water marks, on by default on ground */
+#ifndef CFG_POOL_STATS
+#  if defined(GROUND_BUILD)
+#    define CFG_POOL_STATS     1
+#  else
+#    define CFG_POOL_STATS     0
+#  endif
+#endif
+
+/* Fixed-rate scheduler (section 12): busy-poll below this period, and
+ * how long main() runs the multi-rate demo schedule (0 = skip it) */
+#ifndef CFG_SCHED_BUSY_POLL_NS
+#  define CFG_SCHED_BUSY_POLL_NS 10000u
+#endif
+#ifndef CFG_SCHED_DEMO_MS
+#  define CFG_SCHED_DEMO_MS    0
+#endif
+
+/* Telemetry frames (section 11): 1 = main() writes its frames to a file */
+#ifndef CFG_TLM_DOWNLINK
+#  define CFG_TLM_DOWNLINK     0
+#endif
+#ifndef CFG_TLM_PATH
+#  define CFG_TLM_PATH         "nasa_tlm.bin"
+#endif
+
+/* LOGF backend: 0 = formatted text on stderr, 1 = binary records (see 4) */
+#ifndef CFG_LOG_BINARY
+#  define CFG_LOG_BINARY       0
+#endif
+#ifndef CFG_LOG_BINARY_PATH
+#  define CFG_LOG_BINARY_PATH  "nasa_log.bin"
+#endif
+
+/* Text LOGF/TRACE sink: 1 = lock-free ring drained by a writev thread
+ * (see 4; needs -pthread; ignored with CFG_LOG_BINARY) */
+#ifndef CFG_LOG_ASYNC
+#  define CFG_LOG_ASYNC        0
+#endif
+#ifndef CFG_LOG_ASYNC_PERIOD_US
+#  define CFG_LOG_ASYNC_PERIOD_US 1000  /* background drain interval */
+#endif
+
+/* TRACE backend: 1 = enter/exit events into per-thread rings (see 4) */
+#ifndef CFG_TRACE_RING
+#  define CFG_TRACE_RING       0
+#endif
+#ifndef CFG_TRACE_RING_PATH
+#  define CFG_TRACE_RING_PATH  "nasa_trace.json"
+#endif
+
+/* Live metrics block in POSIX shared memory (section 4b): 1 = main()
+ * publishes loop counts, latency, errors, caps and deadline misses */
+#ifndef CFG_METRICS_SHM
+#  define CFG_METRICS_SHM      0
+#endif
+#ifndef CFG_METRICS_SHM_NAME
+#  define CFG_METRICS_SHM_NAME "/nasa_metrics"
+#endif
+
+/* Warm restart (section 8b): 1 = init_system() restores the last valid
+ * tick's state from CFG_WARM_STATE_PATH, and every valid tick saves it */
+#ifndef CFG_WARM_START
+#  define CFG_WARM_START       0
+#endif
+#ifndef CFG_WARM_STATE_PATH
+#  define CFG_WARM_STATE_PATH  "nasa_warm.bin"
+#endif
+
 /* Safety gate: prevent unsafe thrust in current spacecraft config */
 #if CFG_MAX_THRUST_N > 6000
 #  error "CFG_MAX_THRUST_N exceeds structural limit"
@@ -75,201 +351,3482 @@ STATIC_ASSERT(sizeof(void*) >= 4, pointer_size_must_be_32b_or_more);
  * 3) Branch prediction and attributes (portable wrappers)
  * ------------------------------------------------------------------ */
 #if defined(__GNUC__) || defined(__clang__)
-#  define LIKELY(x)   __builtin_expect(!!(x), 1)
-#  define UNLIKELY(x) __builtin_expect(!!(x), 0)
+#  if CFG_BRANCH_PROFILE
+#    define LIKELY(x)   BRANCH_HINT_(x, #x, 1)
+#    define UNLIKELY(x) BRANCH_HINT_(x, #x, 0)
+#  else
+#    define LIKELY(x)   __builtin_expect(!!(x), 1)
+#    define UNLIKELY(x) __builtin_expect(!!(x), 0)
+#  endif
 #  define NOINLINE    __attribute__((noinline))
+#  define ALWAYS_INLINE inline __attribute__((always_inline))
+#  define COLD        __attribute__((cold))
+#  define NORETURN    __attribute__((noreturn))
 #else
 #  define LIKELY(x)   (x)
 #  define UNLIKELY(x) (x)
 #  define NOINLINE
+#  define ALWAYS_INLINE inline
+#  define COLD
+#  define NORETURN    _Noreturn
 #endif
 
-/* ------------------------------------------------------------------
- * 4) Logging and tracing (zero-cost in flight builds)
- * ------------------------------------------------------------------ */
-#if CFG_ENABLE_LOGS
-#  define LOGF(fmt, ...) \
-      fprintf(stderr, "[LOG] %s:%d %s(): " fmt "\n", __FILE__, __LINE__, __func__, ##__VA_ARGS__)
-#  define TRACE() \
-      fprintf(stderr, "[TRACE] %s:%d in %s()\n", __FILE__, __LINE__, __func__)
-#else
-#  define LOGF(fmt, ...) ((void)0)
-#  define TRACE()        ((void)0)
+/*
+ * Branch-hint verification (CFG_BRANCH_PROFILE=1). Every LIKELY/UNLIKELY
+ * site, including each expansion of SAFE_CALL, ASSERT or SET_THRUST_N,
+ * gets a static record of how often it ran and how often its condition
+ * was true; the hint still reaches __builtin_expect, so code layout is
+ * that of the normal build. Sites link themselves in on first pass. At
+ * exit branch_report() (section 4) lists the hints that went the wrong
+ * way on most passes and writes every site to CFG_BRANCH_PROFILE_PATH as
+ * CSV. Counters are relaxed atomics, so any thread may pass a site.
+ * Sites that never ran do not appear.
+ */
+#if CFG_BRANCH_PROFILE && (defined(__GNUC__) || defined(__clang__))
+typedef struct branch_site {
+    const char           *expr;
+    const char           *file;
+    const char           *func;
+    uint32_t              line;
+    int                   expect;     /* 1 = LIKELY, 0 = UNLIKELY */
+    _Atomic uint64_t      passes;
+    _Atomic uint64_t      taken;      /* passes with the condition true */
+    _Atomic int           linked;
+    struct branch_site   *next;
+} branch_site_t;
+
+static _Atomic(branch_site_t *) g_branch_head;
+
+static void branch_report(void);
+
+static NOINLINE COLD void branch_register(branch_site_t *s) {
+    if (atomic_exchange_explicit(&s->linked, 1, memory_order_relaxed)) return;
+    branch_site_t *h = atomic_load_explicit(&g_branch_head, memory_order_relaxed);
+    do {
+        s->next = h;
+    } while (!atomic_compare_exchange_weak_explicit(&g_branch_head, &h, s,
+                                                    memory_order_release, memory_order_relaxed));
+    if (!h) atexit(branch_report);
+}
+
+/* No LIKELY/UNLIKELY in here: they would recurse */
+static inline int branch_record(branch_site_t *s, int cond) {
+    if (__builtin_expect(!atomic_load_explicit(&s->linked, memory_order_relaxed), 0)) branch_register(s);
+    atomic_fetch_add_explicit(&s->passes, 1, memory_order_relaxed);
+    if (cond) atomic_fetch_add_explicit(&s->taken, 1, memory_order_relaxed);
+    return cond;
+}
+
+#  define BRANCH_HINT_(x, str, e) \
+      __extension__ ({ \
+          static branch_site_t _branch_site = { str, __FILE__, __func__, __LINE__, e, 0, 0, 0, NULL }; \
+          __builtin_expect(branch_record(&_branch_site, !!(x)), e); \
+      })
 #endif
 
-/* ------------------------------------------------------------------
- * 5) Multi-statement macros (statement-safe)
- * ------------------------------------------------------------------ */
-#define SCOPE_DO(block) do { block } while (0)
+/*
+ * Cache-line size of the machine this unit is built for, from the host
+ * compiler's macros: 128 bytes on Apple arm64 and POWER, else 64, which
+ * also fits the CPU_* targets' Cortex-A and RV64 application cores (pass
+ * -DCACHELINE_SIZE=32 for a Cortex-M7). Data written by different threads
+ * goes in different lines: CACHELINE_ALIGNED starts a member or object
+ * on a new line, CACHELINE_PAD(used) fills the rest of a line after
+ * `used` bytes of members.
+ */
+#ifndef CACHELINE_SIZE
+#  if (defined(__APPLE__) && defined(__aarch64__)) || defined(__powerpc64__)
+#    define CACHELINE_SIZE 128
+#  else
+#    define CACHELINE_SIZE 64
+#  endif
+#endif
+#define CACHELINE_ALIGNED  _Alignas(CACHELINE_SIZE)
+#define CACHELINE_PAD(used) \
+    unsigned char PP_CAT(_cacheline_pad_, __LINE__)[CACHELINE_SIZE - (used) % CACHELINE_SIZE]
 
-#define SAFE_CALL(call) \
-    SCOPE_DO({ \
-        int _rc = (call); \
-        if (UNLIKELY(_rc != 0)) { \
-            LOGF("SAFE_CALL failed: %s -> rc=%d", #call, _rc); \
-            exit(EXIT_FAILURE); \
-        } \
-    })
+/* Free-running cycle/tick counter of the host CPU (not the CPU_* target) */
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+static inline uint64_t cycles_now(void) { return __rdtsc(); }
+#elif defined(__aarch64__)
+static inline uint64_t cycles_now(void) {
+    uint64_t v; __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(v)); return v;
+}
+#elif defined(__riscv) && (__riscv_xlen == 64)
+static inline uint64_t cycles_now(void) {
+    uint64_t v; __asm__ __volatile__("rdtime %0" : "=r"(v)); return v;
+}
+#else
+static inline uint64_t cycles_now(void) {
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+#endif
 
-/* Simple runtime assert gated by config */
-#if CFG_ENABLE_ASSERTS
-#  include <assert.h>
-#  define ASSERT(x) SCOPE_DO({ if(!(x)){ LOGF("ASSERT: %s", #x); assert(x); } })
+/* Spin-wait hint: lets the sibling hyperthread run, saves power */
+#if defined(__x86_64__) || defined(__i386__)
+#  define CPU_RELAX() _mm_pause()
+#elif defined(__aarch64__) || (defined(__arm__) && defined(__ARM_ARCH_7A__))
+#  define CPU_RELAX() __asm__ __volatile__("yield" ::: "memory")
 #else
-#  define ASSERT(x) ((void)0)
+#  define CPU_RELAX() ((void)0)
 #endif
 
+/* Monotonic wall clock in nanoseconds */
+static inline uint64_t mono_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* Token helpers and argument counting (0..8 args after a leading one) */
+#define PP_CAT_(a, b) a##b
+#define PP_CAT(a, b)  PP_CAT_(a, b)
+#define PP_NARGS_(a0, a1, a2, a3, a4, a5, a6, a7, a8, N, ...) N
+#define PP_NARGS_AFTER(first, ...) \
+    PP_NARGS_(first, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+
 /* ------------------------------------------------------------------
- * 6) Hardware registers (simulated mapping)
- *    In flight, these would be real memory-mapped addresses. Here we
- *    simulate with a struct so the demo runs on any host.
+ * 4) Logging and tracing (zero-cost in flight builds)
  * ------------------------------------------------------------------ */
-#ifdef SIM_HW_REGS
-typedef struct {
-    volatile uint32_t CTRL;      /* control register */
-    volatile uint32_t STATUS;    /* status register  */
-    volatile uint32_t THRUST;    /* thrust (Newtons) */
-    volatile uint32_t SENS_TEMP; /* temp sensor (raw)*/
-} hw_regs_t;
-static hw_regs_t HW = {0};
-#  define REG32(name)     (HW.name)
+/*
+ * Call-site registry. SITE_DEFINE(var, kind, text) puts one const
+ * descriptor per call site (file, line, function, and the format,
+ * expression or name text) into the "nasa_sites" linker section. The
+ * linker lays them out as one array between __start_nasa_sites and
+ * __stop_nasa_sites, so a site's ID is its index + 1, computed from its
+ * address with no registration at run time; 0 means "no site". Recorded
+ * streams (binary log, trace rings, error counters) store that 2-byte ID
+ * and resolve it with site_at() only when they are dumped or reported.
+ * Needs GCC/clang on ELF (GNU ld, gold, lld) and at most SITE_MAX sites;
+ * elsewhere SITE_REGISTRY is 0 and descriptors are ordinary statics.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__ELF__)
+#  define SITE_REGISTRY 1
+#  define SITE_SECTION_ __attribute__((section("nasa_sites"), used))
 #else
-#  define REG32_PTR(addr) (*(volatile uint32_t*)(addr))
-#  define REG32(name)     REG32_PTR(name)
+#  define SITE_REGISTRY 0
+#  define SITE_SECTION_
 #endif
+#define SITE_MAX 0xFFFFu
 
-/* Bit fields for CTRL */
-#define CTRL_ENABLE   (1u<<0)
-#define CTRL_FAULT    (1u<<1)
+enum { SITE_LOGF, SITE_TRACE, SITE_SAFE_CALL, SITE_ASSERT, SITE_PROFILE, SITE_ERROR };
 
-#define ENABLE_SYSTEM()  SCOPE_DO({ REG32(CTRL) |= CTRL_ENABLE;  LOGF("System ENABLED"); })
-#define DISABLE_SYSTEM() SCOPE_DO({ REG32(CTRL) &= ~CTRL_ENABLE; LOGF("System DISABLED"); })
-#define SIGNAL_FAULT()   SCOPE_DO({ REG32(CTRL) |= CTRL_FAULT;   LOGF("FAULT signaled"); })
+/* Messages of the failure kinds; their text is the stringized expression */
+#define SAFE_CALL_FMT "SAFE_CALL failed: %s -> rc=%d"
+#define ASSERT_FMT    "ASSERT: %s"
 
-/* Thrust write with safety cap */
-#define SET_THRUST_N(newton) \
-    SCOPE_DO({ \
-        uint32_t _n = (uint32_t)(newton); \
-        if (UNLIKELY(_n > CFG_MAX_THRUST_N)) { \
-            LOGF("Thrust request %u exceeds limit %u — capping", _n, (unsigned)CFG_MAX_THRUST_N); \
-            _n = CFG_MAX_THRUST_N; \
-        } \
-        REG32(THRUST) = _n; \
-        LOGF("THRUST set to %u N", _n); \
-    })
+typedef struct {
+    _Alignas(32) const char *file;  /* fixed stride: IDs are array indices */
+    const char *func;
+    const char *text;               /* LOGF format, expression, or PROFILE name */
+    uint32_t    line;
+    uint16_t    kind;
+    uint16_t    reserved;
+} site_t;
 
-/* ------------------------------------------------------------------
- * 7) Platform/arch abstraction (sensor read)
- * ------------------------------------------------------------------ */
-static inline int read_sensor_riscv(int *out) { *out = (int)REG32(SENS_TEMP); return 0; }
-static inline int read_sensor_arm  (int *out) { *out = (int)REG32(SENS_TEMP); return 0; }
+STATIC_ASSERT(sizeof(site_t) == 32, site_t_has_a_fixed_stride);
 
-#if defined(CPU_ARM)
-#  define READ_TEMP_RAW(ptr_int) read_sensor_arm(ptr_int)
-#elif defined(CPU_RISCV)
-#  define READ_TEMP_RAW(ptr_int) read_sensor_riscv(ptr_int)
+#define SITE_DEFINE(var, kind, text) \
+    static const site_t var SITE_SECTION_ = { __FILE__, __func__, text, __LINE__, kind, 0 }
+
+/* printf format a site's records are formatted with */
+static inline const char *site_fmt(const site_t *s) {
+    return s->kind == SITE_SAFE_CALL ? SAFE_CALL_FMT : s->kind == SITE_ASSERT ? ASSERT_FMT : s->text;
+}
+
+#if SITE_REGISTRY
+extern const site_t __start_nasa_sites[] __attribute__((visibility("hidden")));
+extern const site_t __stop_nasa_sites[] __attribute__((visibility("hidden")));
+
+static inline uint16_t site_id(const site_t *s) { return (uint16_t)(s - __start_nasa_sites + 1); }
+
+static inline uint32_t site_count(void) {
+    return (uint32_t)(__stop_nasa_sites - __start_nasa_sites);
+}
+
+static inline const site_t *site_at(uint32_t id) {
+    return id && id <= site_count() ? &__start_nasa_sites[id - 1u] : NULL;
+}
 #endif
 
-/* ------------------------------------------------------------------
- * 8) X-macros: error codes and messages kept in sync
- * ------------------------------------------------------------------ */
-#define ERROR_TABLE \
-    X(ERR_OK,            0,  "No Error") \
-    X(ERR_SENSOR_FAIL,   10, "Sensor Failure") \
-    X(ERR_THRUST_RANGE,  20, "Thrust Out of Range") \
-    X(ERR_SYSTEM_FAULT,  30, "System Fault")
+#if CFG_ENABLE_LOGS && !CFG_LOG_BINARY && CFG_LOG_ASYNC
+/*
+ * Asynchronous text sink. LOG_PRINTF() formats the line straight into a
+ * slot of a bounded lock-free MPSC ring (per-slot sequence numbers, one
+ * CAS to claim a slot) and returns; no stdio lock, no syscall. A
+ * background thread wakes every CFG_LOG_ASYNC_PERIOD_US and hands all
+ * ready lines to one writev(). A producer that finds the ring full drains
+ * it itself if no one else is, then retries once; lines that still don't
+ * fit are counted and the count is reported. Without a sink thread
+ * (creation failed, or exit has begun) lines go straight to stderr.
+ * log_sink_flush() drains
+ * synchronously (bounded by the ring size): it runs on SAFE_CALL/ASSERT
+ * failure and at exit, so an abort loses nothing already formatted.
+ * A writev() interrupted by a signal is retried, and a non-blocking
+ * stderr that is full is waited on for up to LOG_ASYNC_STALL_MS; only
+ * other errors discard the batch.
+ * Other direct fprintf(stderr) output is not ordered against the ring.
+ * Build with -pthread.
+ */
+#  include <poll.h>
+#  include <pthread.h>
+#  include <stdarg.h>
+#  include <sys/uio.h>
+#  include <unistd.h>
 
-typedef enum {
-#define X(name, code, msg) name = code,
-    ERROR_TABLE
-#undef X
-} error_t;
+#  define LOG_ASYNC_SLOTS   1024u   /* power of two */
+#  define LOG_ASYNC_LINE    248u    /* longer lines are truncated */
+#  define LOG_ASYNC_BATCH   64u     /* iovecs per writev */
+#  define LOG_ASYNC_STALL_MS 100    /* wait per EAGAIN before discarding */
 
-static const char* error_to_str(error_t e) {
-    switch (e) {
-#define X(name, code, msg) case name: return msg;
-        ERROR_TABLE
-#undef X
-        default: return "Unknown";
+typedef struct {
+    _Atomic uint64_t seq;           /* == pos: free, == pos + 1: holds line pos */
+    uint32_t         len;
+    char             text[LOG_ASYNC_LINE];
+} log_line_t;
+
+static struct {
+    CACHELINE_ALIGNED _Atomic uint64_t enq;    /* producers claim here */
+    CACHELINE_ALIGNED uint64_t         deq;    /* owned by whoever holds drain */
+    atomic_flag                        drain;
+    _Atomic uint64_t                   dropped;
+    _Atomic int                        state;  /* 0 idle, 1 starting, 2 running, 3 stopped */
+    _Atomic int                        stop;
+    pthread_t                          thread;
+    log_line_t                         ring[LOG_ASYNC_SLOTS];
+} g_sink = { .drain = ATOMIC_FLAG_INIT };
+
+/* Write every ready line; returns 0 if another thread was already draining */
+static int log_sink_drain(void) {
+    if (atomic_flag_test_and_set_explicit(&g_sink.drain, memory_order_acquire)) return 0;
+    for (;;) {
+        struct iovec iov[LOG_ASYNC_BATCH];
+        unsigned n = 0;
+        while (n < LOG_ASYNC_BATCH) {
+            log_line_t *l = &g_sink.ring[(g_sink.deq + n) & (LOG_ASYNC_SLOTS - 1u)];
+            if (atomic_load_explicit(&l->seq, memory_order_acquire) != g_sink.deq + n + 1u) break;
+            iov[n].iov_base = l->text;
+            iov[n].iov_len  = l->len;
+            ++n;
+        }
+        if (n == 0) break;
+        struct iovec *v = iov;
+        unsigned left = n;
+        while (left) {
+            ssize_t w = writev(STDERR_FILENO, v, (int)left);
+            if (w < 0) {
+                if (errno == EINTR) continue;           /* signal mid-drain: retry */
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    struct pollfd pfd = { STDERR_FILENO, POLLOUT, 0 };
+                    if (poll(&pfd, 1, LOG_ASYNC_STALL_MS) > 0) continue;
+                }
+                break;                                  /* stderr gone or stuck: discard */
+            }
+            while (left && (size_t)w >= v->iov_len) { w -= (ssize_t)v->iov_len; ++v; --left; }
+            if (left) { v->iov_base = (char *)v->iov_base + w; v->iov_len -= (size_t)w; }
+        }
+        for (unsigned i = 0; i < n; ++i, ++g_sink.deq) {
+            atomic_store_explicit(&g_sink.ring[g_sink.deq & (LOG_ASYNC_SLOTS - 1u)].seq,
+                                  g_sink.deq + LOG_ASYNC_SLOTS, memory_order_release);
+        }
     }
+    atomic_flag_clear_explicit(&g_sink.drain, memory_order_release);
+    return 1;
 }
 
-/* ------------------------------------------------------------------
- * 9) Tiny guidance/control demo using the macros above
- * ------------------------------------------------------------------ */
-static NOINLINE int init_system(void) {
-    TRACE();
-    ENABLE_SYSTEM();
-    REG32(SENS_TEMP) = 42; /* seed */
-    return 0; /* simulate success */
+static void *log_sink_main(void *arg) {
+    (void)arg;
+    const struct timespec period = { 0, (long)CFG_LOG_ASYNC_PERIOD_US * 1000L };
+    while (!atomic_load_explicit(&g_sink.stop, memory_order_acquire)) {
+        (void)log_sink_drain();
+        nanosleep(&period, NULL);
+    }
+    return NULL;
 }
 
-static NOINLINE int poll_temperature_c(int *out_c) {
-    TRACE();
-    int raw = 0;
-    if (READ_TEMP_RAW(&raw) != 0) return ERR_SENSOR_FAIL;
-    /* Simple linearization: raw -> Celsius */
-    *out_c = raw; /* pretend already degC */
-    LOGF("Temp=%d C", *out_c);
-    return ERR_OK;
+/* Drain now, waiting out a concurrent drainer (never blocks for long) */
+static NOINLINE void log_sink_flush(void) {
+    if (atomic_load_explicit(&g_sink.state, memory_order_acquire) == 0) return;
+    while (!log_sink_drain()) {}
+    (void)log_sink_drain();                             /* lines added meanwhile */
 }
 
-static NOINLINE int command_thrust(uint32_t desired_n) {
-    TRACE();
-    if (desired_n > (CFG_MAX_THRUST_N * 2)) {
-        return ERR_THRUST_RANGE; /* clearly insane input */
+static void log_sink_at_exit(void) {
+    if (atomic_exchange(&g_sink.state, 3) == 2) {
+        atomic_store_explicit(&g_sink.stop, 1, memory_order_release);
+        pthread_join(g_sink.thread, NULL);
     }
-    SET_THRUST_N(desired_n);
-    return ERR_OK;
+    while (!log_sink_drain()) {}
+    uint64_t dropped = atomic_load(&g_sink.dropped);
+    if (dropped) fprintf(stderr, "[LOG] %llu lines dropped (sink ring full)\n",
+                         (unsigned long long)dropped);
 }
 
-static NOINLINE int run_control_loop_once(void) {
-    TRACE();
-    int temp_c = 0;
-    int rc = poll_temperature_c(&temp_c);
-    if (rc != ERR_OK) return rc;
+static NOINLINE COLD void log_sink_start(void) {
+    int idle = 0;
+    if (!atomic_compare_exchange_strong(&g_sink.state, &idle, 1)) return;
+    for (unsigned i = 0; i < LOG_ASYNC_SLOTS; ++i) atomic_init(&g_sink.ring[i].seq, i);
+    atexit(log_sink_at_exit);
+    int running = pthread_create(&g_sink.thread, NULL, log_sink_main, NULL) == 0;
+    atomic_store_explicit(&g_sink.state, running ? 2 : 3, memory_order_release);
+}
 
-    /* Simple policy: map temperature to thrust */
-    uint32_t desired = (temp_c < 30) ? 3000 : 1500; // demo policy
-    rc = command_thrust(desired);
-    if (rc != ERR_OK) return rc;
+__attribute__((format(printf, 1, 2)))
+static void log_sink_printf(const char *fmt, ...) {
+    if (UNLIKELY(atomic_load_explicit(&g_sink.state, memory_order_acquire) != 2)) {
+        log_sink_start();
+        while (atomic_load_explicit(&g_sink.state, memory_order_acquire) == 1) {}
+        if (atomic_load_explicit(&g_sink.state, memory_order_acquire) == 3) {
+            va_list ap;                     /* no sink thread (or after exit): write directly */
+            va_start(ap, fmt);
+            vfprintf(stderr, fmt, ap);
+            va_end(ap);
+            return;
+        }
+    }
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        uint64_t pos = atomic_load_explicit(&g_sink.enq, memory_order_relaxed);
+        for (;;) {
+            log_line_t *l = &g_sink.ring[pos & (LOG_ASYNC_SLOTS - 1u)];
+            int64_t diff = (int64_t)(atomic_load_explicit(&l->seq, memory_order_acquire) - pos);
+            if (diff == 0) {
+                if (!atomic_compare_exchange_weak_explicit(&g_sink.enq, &pos, pos + 1u,
+                                                           memory_order_relaxed,
+                                                           memory_order_relaxed)) continue;
+                va_list ap;
+                va_start(ap, fmt);
+                int n = vsnprintf(l->text, sizeof l->text, fmt, ap);
+                va_end(ap);
+                if (n < 0) n = 0;
+                if ((size_t)n >= sizeof l->text) {              /* truncated: keep the newline */
+                    n = (int)sizeof l->text - 1;
+                    l->text[n - 1] = '\n';
+                }
+                l->len = (uint32_t)n;
+                atomic_store_explicit(&l->seq, pos + 1u, memory_order_release);
+                return;
+            }
+            if (diff < 0) break;                                /* full */
+            pos = atomic_load_explicit(&g_sink.enq, memory_order_relaxed);
+        }
+        if (attempt == 0) (void)log_sink_drain();
+    }
+    atomic_fetch_add_explicit(&g_sink.dropped, 1u, memory_order_relaxed);
+}
+
+#  define LOG_PRINTF(...)   log_sink_printf(__VA_ARGS__)
+#  define LOG_SINK_FLUSH()  log_sink_flush()
+#elif CFG_ENABLE_LOGS && CFG_LOG_BINARY
+static void log_bin_flush(void);   /* binary backend below: dump the ring now */
+#  define LOG_PRINTF(...)   fprintf(stderr, __VA_ARGS__)
+#  define LOG_SINK_FLUSH()  log_bin_flush()
+#else
+#  define LOG_PRINTF(...)   fprintf(stderr, __VA_ARGS__)
+#  define LOG_SINK_FLUSH()  ((void)0)
+#endif
+
+#if CFG_ENABLE_LOGS && CFG_LOG_BINARY
+/*
+ * Deferred-format backend. Each call site is a registry descriptor
+ * (file/line/func/fmt), so the hot path only stores {site ID, timestamp,
+ * raw argument words} into a preallocated ring; the first record also
+ * arms the dump: at exit, on every LOG_SINK_FLUSH() (SAFE_CALL/ASSERT
+ * failures, before exit() or abort()), and from a handler for fatal
+ * signals (SIGABRT, SIGSEGV, SIGBUS, SIGFPE, SIGILL) that have none
+ * installed, which then re-raises. The dump uses only open/write/close,
+ * so it is safe in that handler. Formatting happens offline in
+ * NASA_LOG_DECODER.c, which reproduces the text backend's lines exactly.
+ * Arguments must be integers or pointers; %s arguments must point to
+ * static-storage strings (literals), as they are resolved at dump time.
+ */
+#  if !SITE_REGISTRY
+#    error "CFG_LOG_BINARY needs the call-site registry (GCC/clang on ELF)"
+#  endif
+#  define LOG_MAX_ARGS   6
+#  define LOG_RING_SIZE  4096u  /* records; power of two */
+#  define LOG_KIND_LOGF  0u     /* site kinds as stored in the dump */
+#  define LOG_KIND_TRACE 1u
+
+typedef struct {                 /* 64 bytes: one cache line per record */
+    uint64_t ts;
+    uint16_t site;
+    uint16_t nargs;
+    _Atomic uint32_t seq;        /* low bits of (index + 1) once committed */
+    uint64_t arg[LOG_MAX_ARGS];
+} log_rec_t;
+
+STATIC_ASSERT((LOG_RING_SIZE & (LOG_RING_SIZE - 1u)) == 0, log_ring_size_pow2);
+STATIC_ASSERT(sizeof(log_rec_t) == 64, log_rec_is_one_cache_line);
+
+static struct {
+    _Atomic uint64_t head;
+    log_rec_t        ring[LOG_RING_SIZE];
+} g_log;
+
+static void log_bin_arm(void);
+
+static inline void log_bin_emit(uint16_t id, unsigned n, const uint64_t *a) {
+    uint64_t idx = atomic_fetch_add_explicit(&g_log.head, 1u, memory_order_relaxed);
+    if (UNLIKELY(idx == 0)) log_bin_arm();
+    log_rec_t *r = &g_log.ring[idx & (LOG_RING_SIZE - 1u)];
+    r->ts    = cycles_now();
+    r->site  = id;
+    r->nargs = (uint16_t)n;
+    for (unsigned i = 0; i < n; ++i) r->arg[i] = a[i];
+    atomic_store_explicit(&r->seq, (uint32_t)(idx + 1u), memory_order_release);
+}
+
+#  define LOG_ARG(x) ((uint64_t)(uintptr_t)(x))
+#  define LOG_PACK_0(f)
+#  define LOG_PACK_1(f, a)                , LOG_ARG(a)
+#  define LOG_PACK_2(f, a, b)             , LOG_ARG(a), LOG_ARG(b)
+#  define LOG_PACK_3(f, a, b, c)          LOG_PACK_2(f, a, b), LOG_ARG(c)
+#  define LOG_PACK_4(f, a, b, c, d)       LOG_PACK_3(f, a, b, c), LOG_ARG(d)
+#  define LOG_PACK_5(f, a, b, c, d, e)    LOG_PACK_4(f, a, b, c, d), LOG_ARG(e)
+#  define LOG_PACK_6(f, a, b, c, d, e, g) LOG_PACK_5(f, a, b, c, d, e), LOG_ARG(g)
+
+#  define LOG_BIN(kind_, fmt, ...) \
+      do { \
+          SITE_DEFINE(_ls, kind_, fmt); \
+          STATIC_ASSERT(PP_NARGS_AFTER(fmt, ##__VA_ARGS__) <= LOG_MAX_ARGS, too_many_log_args); \
+          const uint64_t _la[] = { 0 PP_CAT(LOG_PACK_, PP_NARGS_AFTER(fmt, ##__VA_ARGS__))(fmt, ##__VA_ARGS__) }; \
+          log_bin_emit(site_id(&_ls), PP_NARGS_AFTER(fmt, ##__VA_ARGS__), _la + 1); \
+      } while (0)
+#  define LOGF(fmt, ...) LOG_BIN(SITE_LOGF, fmt, ##__VA_ARGS__)
+#  define TRACE()        LOG_BIN(SITE_TRACE, "")
+
+/*
+ * Printf conversion scanner shared by the dumper and the offline decoder.
+ * Returns a pointer just past the next conversion spec in fmt (or NULL at
+ * end of string), copying the spec into spec[] and its final letter into
+ * *conv. "%%" is reported as conv '%'.
+ */
+static const char *log_fmt_next(const char *fmt, char *spec, size_t cap, char *conv) {
+    const char *p = strchr(fmt, '%');
+    if (!p) return NULL;
+    const char *q = p + 1;
+    while (*q && !strchr("diouxXcspn%", *q)) ++q;
+    if (!*q) return NULL;
+    size_t len = (size_t)(q - p) + 1u;
+    if (len >= cap) len = cap - 1u;
+    memcpy(spec, p, len);
+    spec[len] = '\0';
+    *conv = *q;
+    return q + 1;
+}
 
-    if (UNLIKELY(REG32(CTRL) & CTRL_FAULT)) {
-        return ERR_SYSTEM_FAULT;
+/*
+ * Dump file layout (native endianness, rewritten by every dump):
+ *   "NLOG" u32 version | u32 nsites | u64 nrecs | u64 lost
+ *   nsites x { u16 id, u16 kind, u32 line, str file, str func, str fmt }
+ *   nrecs  x { u64 ts, u16 site, u16 nargs, nargs x arg }
+ * where str = u16 length + bytes, and arg is a str for %s, else a u64.
+ */
+#  define LOG_DUMP_VERSION 1u
+
+#  include <fcntl.h>
+#  include <signal.h>
+#  include <unistd.h>
+
+/* Buffered writer on write(2): no stdio, no malloc (signal-handler safe) */
+typedef struct {
+    int           fd;
+    int           err;
+    size_t        n;
+    unsigned char buf[4096];
+} log_out_t;
+
+static void log_out_drain(log_out_t *o) {
+    for (size_t off = 0; off < o->n && !o->err;) {
+        ssize_t w = write(o->fd, o->buf + off, o->n - off);
+        if (w > 0) off += (size_t)w;
+        else if (w < 0 && errno == EINTR) continue;
+        else o->err = 1;
     }
-    return ERR_OK;
+    o->n = 0;
 }
 
-/* ------------------------------------------------------------------
- * 10) Main: tie it together
- * ------------------------------------------------------------------ */
-int main(void) {
-    LOGF("Build: %s %s | C%ld | Hosted=%d",
-         __DATE__, __TIME__, (long)__STDC_VERSION__, (int)__STDC_HOSTED__);
+static void log_out(log_out_t *o, const void *p, size_t len) {
+    const unsigned char *b = p;
+    while (len) {
+        if (o->n == sizeof o->buf) log_out_drain(o);
+        size_t k = sizeof o->buf - o->n < len ? sizeof o->buf - o->n : len;
+        memcpy(o->buf + o->n, b, k);
+        o->n += k;
+        b += k;
+        len -= k;
+    }
+}
 
-    SAFE_CALL(init_system());
+static void log_put_str(log_out_t *o, const char *s) {
+    size_t n = s ? strlen(s) : 0u;
+    if (n > 0xFFFFu) n = 0xFFFFu;
+    uint16_t n16 = (uint16_t)n;
+    log_out(o, &n16, sizeof n16);
+    if (n) log_out(o, s, n);
+}
 
-    /* Self-checks */
-    ASSERT((CFG_MAX_THRUST_N % 10) == 0);
+/* Registry sites that can emit records; the dump describes only those */
+static const site_t *log_bin_site(uint32_t id) {
+    const site_t *s = site_at(id);
+    return s && (s->kind == SITE_LOGF || s->kind == SITE_TRACE ||
+                 s->kind == SITE_SAFE_CALL || s->kind == SITE_ASSERT) ? s : NULL;
+}
 
-    /* Demo loop */
-    for (int i = 0; i < 3; ++i) {
-        int rc = run_control_loop_once();
-        if (rc != ERR_OK) {
-            fprintf(stderr, "ERROR %d: %s\n", rc, error_to_str(rc));
-            break;
-        }
-        /* Mutate temp to exercise policy */
-        REG32(SENS_TEMP) += 5;
+static int log_bin_dump(const char *path) {
+    static log_out_t out;           /* not on the stack: may run on a small signal stack */
+    log_out_t *f = &out;
+    f->fd  = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    f->err = 0;
+    f->n   = 0;
+    if (f->fd < 0) return -1;
+    uint32_t nsites = site_count() < SITE_MAX ? site_count() : SITE_MAX;
+    uint64_t head  = atomic_load(&g_log.head);
+    uint64_t first = head > LOG_RING_SIZE ? head - LOG_RING_SIZE : 0u;
+    uint64_t nrecs = 0;
+    for (uint64_t i = first; i < head; ++i) {
+        if (atomic_load(&g_log.ring[i & (LOG_RING_SIZE - 1u)].seq) == (uint32_t)(i + 1u)) ++nrecs;
     }
+    uint64_t lost = head - nrecs;
+    uint32_t ver  = LOG_DUMP_VERSION;
+    uint32_t nreg = 0;
+    for (uint32_t id = 1; id <= nsites; ++id) nreg += log_bin_site(id) != NULL;
 
-    /* Exercise fault path */
-    SIGNAL_FAULT();
-    int rc = run_control_loop_once();
-    if (rc != ERR_OK) {
-        fprintf(stderr, "ERROR %d: %s\n", rc, error_to_str(rc));
+    log_out(f, "NLOG", 4);
+    log_out(f, &ver, sizeof ver);
+    log_out(f, &nreg, sizeof nreg);
+    log_out(f, &nrecs, sizeof nrecs);
+    log_out(f, &lost, sizeof lost);
+    for (uint32_t id = 1; id <= nsites; ++id) {
+        const site_t *s = log_bin_site(id);
+        if (!s) continue;
+        uint16_t id16 = (uint16_t)id, kind16 = s->kind == SITE_TRACE ? LOG_KIND_TRACE : LOG_KIND_LOGF;
+        log_out(f, &id16, sizeof id16);
+        log_out(f, &kind16, sizeof kind16);
+        log_out(f, &s->line, sizeof s->line);
+        log_put_str(f, s->file);
+        log_put_str(f, s->func);
+        log_put_str(f, site_fmt(s));
     }
+    for (uint64_t i = first; i < head; ++i) {
+        const log_rec_t *r = &g_log.ring[i & (LOG_RING_SIZE - 1u)];
+        if (atomic_load(&r->seq) != (uint32_t)(i + 1u)) continue;
+        log_out(f, &r->ts, sizeof r->ts);
+        log_out(f, &r->site, sizeof r->site);
+        log_out(f, &r->nargs, sizeof r->nargs);
+        const char *p = site_fmt(site_at(r->site));
+        char spec[32], conv = 0;
+        for (unsigned a = 0; a < r->nargs; ++a) {
+            do { p = p ? log_fmt_next(p, spec, sizeof spec, &conv) : NULL; } while (p && conv == '%');
+            if (p && conv == 's') log_put_str(f, (const char *)(uintptr_t)r->arg[a]);
+            else log_out(f, &r->arg[a], sizeof r->arg[a]);
+        }
+    }
+    log_out_drain(f);
+    return close(f->fd) != 0 || f->err ? -1 : 0;
+}
 
-    DISABLE_SYSTEM();
+/* One dump at a time: a fatal signal during a dump leaves that one to finish */
+static atomic_flag g_log_dumping = ATOMIC_FLAG_INIT;
+
+static int log_bin_dump_once(void) {
+    if (atomic_flag_test_and_set(&g_log_dumping)) return 0;
+    int rc = log_bin_dump(CFG_LOG_BINARY_PATH);
+    atomic_flag_clear(&g_log_dumping);
+    return rc;
+}
+
+static void log_bin_flush(void) {
+    if (log_bin_dump_once() != 0) {
+        fprintf(stderr, "[LOG] failed to write %s\n", CFG_LOG_BINARY_PATH);
+    }
+}
+
+static void log_bin_on_fatal(int sig) {
+    static const char msg[] = "[LOG] fatal signal: ring dumped to " CFG_LOG_BINARY_PATH "\n";
+    int saved = errno;
+    if (log_bin_dump_once() == 0) (void)!write(STDERR_FILENO, msg, sizeof msg - 1u);
+    errno = saved;
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+static NOINLINE COLD void log_bin_arm(void) {
+    static const int fatal[] = { SIGABRT, SIGSEGV, SIGBUS, SIGFPE, SIGILL };
+    atexit(log_bin_flush);
+    for (unsigned i = 0; i < sizeof fatal / sizeof fatal[0]; ++i) {
+        struct sigaction sa, old;
+        memset(&sa, 0, sizeof sa);
+        sa.sa_handler = log_bin_on_fatal;
+        sigemptyset(&sa.sa_mask);
+        sa.sa_flags = SA_NODEFER;            /* the re-raise must not be held back */
+        if (sigaction(fatal[i], NULL, &old) == 0 && old.sa_handler == SIG_DFL) {
+            (void)sigaction(fatal[i], &sa, NULL);
+        }
+    }
+}
+#elif CFG_ENABLE_LOGS
+#  define LOGF(fmt, ...) \
+      LOG_PRINTF("[LOG] %s:%d %s(): " fmt "\n", __FILE__, __LINE__, __func__, ##__VA_ARGS__)
+#  define TRACE() \
+      LOG_PRINTF("[TRACE] %s:%d in %s()\n", __FILE__, __LINE__, __func__)
+#else
+#  define LOGF(fmt, ...) ((void)0)
+#  define TRACE()        ((void)0)
+#endif
+
+#if CFG_ENABLE_LOGS && CFG_TRACE_RING
+/*
+ * Ring-buffer tracer. TRACE() declares a scope guard, so each traced
+ * function records an enter event and (via the cleanup attribute) an exit
+ * event with a cycle-counter timestamp. Every thread claims its own fixed
+ * ring on first use: the owner is the only writer, so recording is one
+ * plain store and one release store, with no locks and no formatting.
+ * An event is one 64-bit word: the low 47 bits of the tick counter, the
+ * registry ID of the TRACE() site and the phase bit. The dump restores
+ * the high tick bits from its own time, which holds for events newer than
+ * 2^47 ticks (about 13 hours at 3 GHz). The newest TRACE_RING_EVENTS
+ * events per thread survive; trace_dump_chrome() writes them as Chrome
+ * trace JSON on demand, and once more at exit.
+ * TRACE() must appear at block scope as a statement of its own.
+ */
+#  if !(defined(__GNUC__) || defined(__clang__)) || !SITE_REGISTRY
+#    error "CFG_TRACE_RING needs the GCC/Clang cleanup attribute and the call-site registry (ELF)"
+#  endif
+#  define TRACE_MAX_THREADS  8u
+#  define TRACE_RING_EVENTS  16384u /* per thread; power of two */
+#  define TRACE_PH_BEGIN     0u
+#  define TRACE_PH_END       1u
+#  define TRACE_TS_BITS      47u
+#  define TRACE_TS_MASK      ((UINT64_C(1) << TRACE_TS_BITS) - 1u)
+
+typedef uint64_t trace_ev_t;     /* ts:47 | site:16 | phase:1 */
+
+#  define TRACE_EV(ts, site, phase) \
+      (((uint64_t)(ts) & TRACE_TS_MASK) << 17 | (uint64_t)(site) << 1 | (phase))
+#  define TRACE_EV_TS(e)    ((e) >> 17)
+#  define TRACE_EV_SITE(e)  ((uint16_t)((e) >> 1))
+#  define TRACE_EV_PHASE(e) ((uint32_t)(e) & 1u)
+
+typedef struct {
+    _Atomic uint64_t head;       /* written only by the owning thread */
+    trace_ev_t       ev[TRACE_RING_EVENTS];
+} trace_ring_t;
+
+STATIC_ASSERT((TRACE_RING_EVENTS & (TRACE_RING_EVENTS - 1u)) == 0, trace_ring_size_pow2);
+
+static struct {
+    _Atomic uint32_t nrings;
+    _Atomic uint64_t dropped;    /* events from threads beyond TRACE_MAX_THREADS */
+    uint64_t         t0_ticks;
+    struct timespec  t0_wall;
+    trace_ring_t     rings[TRACE_MAX_THREADS];
+} g_trace;
+
+static _Thread_local trace_ring_t *tl_trace_ring;
+static _Thread_local int           tl_trace_full;
+
+static void trace_dump_at_exit(void);
+
+static NOINLINE trace_ring_t *trace_claim_ring(void) {
+    uint32_t i = atomic_fetch_add_explicit(&g_trace.nrings, 1u, memory_order_relaxed);
+    if (i == 0) {
+        g_trace.t0_ticks = cycles_now();
+        clock_gettime(CLOCK_MONOTONIC, &g_trace.t0_wall);
+        atexit(trace_dump_at_exit);
+    }
+    if (i >= TRACE_MAX_THREADS) { tl_trace_full = 1; return NULL; }
+    return tl_trace_ring = &g_trace.rings[i];
+}
+
+static inline void trace_record(uint16_t id, uint32_t phase) {
+    trace_ring_t *r = tl_trace_ring;
+    if (UNLIKELY(!r)) {
+        if (tl_trace_full || !(r = trace_claim_ring())) {
+            atomic_fetch_add_explicit(&g_trace.dropped, 1u, memory_order_relaxed);
+            return;
+        }
+    }
+    uint64_t h = atomic_load_explicit(&r->head, memory_order_relaxed);
+    r->ev[h & (TRACE_RING_EVENTS - 1u)] = TRACE_EV(cycles_now(), id, phase);
+    atomic_store_explicit(&r->head, h + 1u, memory_order_release);
+}
+
+static inline uint16_t trace_enter(uint16_t id) {
+    trace_record(id, TRACE_PH_BEGIN);
+    return id;
+}
+
+static inline void trace_exit(uint16_t *id) { trace_record(*id, TRACE_PH_END); }
+
+#  undef TRACE
+#  define TRACE() \
+      SITE_DEFINE(PP_CAT(_trace_site_, __LINE__), SITE_TRACE, ""); \
+      __attribute__((cleanup(trace_exit))) uint16_t PP_CAT(_trace_id_, __LINE__) = \
+          trace_enter(site_id(&PP_CAT(_trace_site_, __LINE__)))
+
+/*
+ * Chrome trace / Perfetto JSON export. Tick stamps are converted to
+ * microseconds using the tick rate observed between the first event and
+ * the dump. Exits whose enter has already been overwritten are skipped.
+ * Rings of threads still running are read without stopping them, so their
+ * newest few events may be missing or torn.
+ */
+static int trace_dump_chrome(const char *path) {
+    uint32_t nrings = atomic_load(&g_trace.nrings);
+    if (nrings == 0) return 0;
+    if (nrings > TRACE_MAX_THREADS) nrings = TRACE_MAX_THREADS;
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+
+    struct timespec t1;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    uint64_t now   = cycles_now();
+    uint64_t ticks = now - g_trace.t0_ticks;
+    double   ns    = (double)(t1.tv_sec - g_trace.t0_wall.tv_sec) * 1e9 +
+                     (double)(t1.tv_nsec - g_trace.t0_wall.tv_nsec);
+    double   us_per_tick = (ticks && ns > 0.0) ? ns / 1e3 / (double)ticks : 1e-3;
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", f);
+    const char *sep = "";
+    for (uint32_t t = 0; t < nrings; ++t) {
+        const trace_ring_t *r = &g_trace.rings[t];
+        uint64_t head  = atomic_load_explicit(&r->head, memory_order_acquire);
+        uint64_t first = head > TRACE_RING_EVENTS ? head - TRACE_RING_EVENTS : 0u;
+        fprintf(f, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,"
+                   "\"args\":{\"name\":\"nasa-%u\"}}", sep, (unsigned)t, (unsigned)t);
+        sep = ",\n";
+        uint64_t depth = 0;
+        for (uint64_t i = first; i < head; ++i) {
+            trace_ev_t e = r->ev[i & (TRACE_RING_EVENTS - 1u)];
+            const site_t *s = site_at(TRACE_EV_SITE(e));
+            if (!s) continue;
+            uint32_t phase = TRACE_EV_PHASE(e);
+            if (phase == TRACE_PH_END) { if (depth == 0) continue; --depth; }
+            else ++depth;
+            uint64_t at = now - ((now - TRACE_EV_TS(e)) & TRACE_TS_MASK);
+            double ts = (double)(int64_t)(at - g_trace.t0_ticks) * us_per_tick;
+            fprintf(f, "%s{\"ph\":\"%c\",\"name\":\"%s\",\"cat\":\"nasa\",\"pid\":1,\"tid\":%u,"
+                       "\"ts\":%.3f,\"args\":{\"file\":\"%s\",\"line\":%u}}",
+                    sep, phase == TRACE_PH_END ? 'E' : 'B', s->func, (unsigned)t, ts,
+                    s->file, (unsigned)s->line);
+        }
+    }
+    fputs("]}\n", f);
+    uint64_t dropped = atomic_load(&g_trace.dropped);
+    if (dropped) fprintf(stderr, "[TRACE] %llu events dropped (more than %u threads)\n",
+                         (unsigned long long)dropped, TRACE_MAX_THREADS);
+    return fclose(f);
+}
+
+static void trace_dump_at_exit(void) {
+    if (trace_dump_chrome(CFG_TRACE_RING_PATH) != 0) {
+        fprintf(stderr, "[TRACE] failed to write %s\n", CFG_TRACE_RING_PATH);
+    }
+}
+#endif
+
+/*
+ * Per-site cycle profiling. PROFILE_SCOPE(name) times the rest of the
+ * enclosing block (cleanup attribute); PROFILE_BEGIN(name)/PROFILE_END(name)
+ * time an explicit region in the same block. Each site keeps count, total,
+ * min and max ticks in its own static record: one counter read at each
+ * end and four plain updates, no atomics. Records are not shared between
+ * threads, so profile code that runs on one thread (the control thread).
+ * Sites link themselves into a list on first use; prof_report() prints
+ * them, and runs once at exit. Flight builds get ((void)0).
+ */
+#if CFG_ENABLE_LOGS && CFG_PROFILE
+typedef struct prof_site {
+    const site_t      *site;     /* name, file and line */
+    uint64_t           count;
+    uint64_t           total;
+    uint64_t           min;
+    uint64_t           max;
+    struct prof_site  *next;
+} prof_site_t;
+
+typedef struct {
+    prof_site_t *site;
+    uint64_t     t0;
+} prof_guard_t;
+
+static struct {
+    prof_site_t     *head;
+    uint64_t         t0_ticks;
+    uint64_t         t0_ns;
+} g_prof;
+
+static void prof_report(void) {
+    uint64_t ticks = cycles_now() - g_prof.t0_ticks, ns = mono_ns() - g_prof.t0_ns;
+    double   ns_per_tick = ticks ? (double)ns / (double)ticks : 0.0;
+    for (const prof_site_t *s = g_prof.head; s; s = s->next) {
+        if (!s->count) continue;
+        double mean = (double)s->total / (double)s->count;
+        LOG_PRINTF("[PROF] %-24s %s:%u count=%llu mean=%.1f min=%llu max=%llu ticks "
+                   "(mean %.1f ns)\n",
+                   s->site->text, s->site->file, (unsigned)s->site->line,
+                   (unsigned long long)s->count, mean,
+                   (unsigned long long)s->min, (unsigned long long)s->max, mean * ns_per_tick);
+    }
+}
+
+static NOINLINE COLD void prof_register(prof_site_t *s) {
+    if (!g_prof.head) {
+        g_prof.t0_ticks = cycles_now();
+        g_prof.t0_ns    = mono_ns();
+        atexit(prof_report);
+    }
+    s->min  = UINT64_MAX;
+    s->next = g_prof.head;
+    g_prof.head = s;
+}
+
+static inline void prof_record(prof_site_t *s, uint64_t dt) {
+    if (UNLIKELY(s->count == 0)) prof_register(s);
+    s->count++;
+    s->total += dt;
+    if (dt < s->min) s->min = dt;
+    if (dt > s->max) s->max = dt;
+}
+
+static inline void prof_scope_end(prof_guard_t *g) { prof_record(g->site, cycles_now() - g->t0); }
+
+#  define PROF_SITE_DEFINE(var, name) \
+      SITE_DEFINE(PP_CAT(var, _desc), SITE_PROFILE, #name); \
+      static prof_site_t var = { &PP_CAT(var, _desc), 0, 0, 0, 0, NULL }
+#  define PROFILE_BEGIN(name) \
+      PROF_SITE_DEFINE(_prof_site_##name, name); \
+      const uint64_t _prof_t0_##name = cycles_now()
+#  define PROFILE_END(name) prof_record(&_prof_site_##name, cycles_now() - _prof_t0_##name)
+#  if defined(__GNUC__) || defined(__clang__)
+#    define PROFILE_SCOPE(name) \
+         PROF_SITE_DEFINE(PP_CAT(_prof_site_, __LINE__), name); \
+         __attribute__((cleanup(prof_scope_end))) prof_guard_t PP_CAT(_prof_guard_, __LINE__) = \
+             { &PP_CAT(_prof_site_, __LINE__), cycles_now() }
+#  else
+#    define PROFILE_SCOPE(name) ((void)0)  /* needs the cleanup attribute */
+#  endif
+#else
+#  define PROFILE_SCOPE(name) ((void)0)
+#  define PROFILE_BEGIN(name) ((void)0)
+#  define PROFILE_END(name)   ((void)0)
+#endif
+
+/* Exit report for CFG_BRANCH_PROFILE (sites are defined in section 3) */
+#if CFG_BRANCH_PROFILE && (defined(__GNUC__) || defined(__clang__))
+static void branch_csv_quoted(FILE *f, const char *str) {
+    fputc('"', f);
+    for (; *str; ++str) {
+        if (*str == '"') fputc('"', f);
+        fputc(*str, f);
+    }
+    fputc('"', f);
+}
+
+static void branch_report(void) {
+    unsigned sites = 0, wrong = 0;
+    FILE *csv = fopen(CFG_BRANCH_PROFILE_PATH, "w");
+    if (csv) fputs("file,line,func,hint,expr,passes,taken\n", csv);
+    for (const branch_site_t *s = atomic_load_explicit(&g_branch_head, memory_order_acquire);
+         s; s = s->next) {
+        uint64_t n = atomic_load_explicit(&s->passes, memory_order_relaxed);
+        uint64_t t = atomic_load_explicit(&s->taken, memory_order_relaxed);
+        uint64_t against = s->expect ? n - t : t;
+        const char *hint = s->expect ? "LIKELY" : "UNLIKELY";
+        ++sites;
+        if (2u * against > n) {
+            ++wrong;
+            LOG_PRINTF("[BRANCH] wrong hint %s(%s) at %s:%u %s(): against it on "
+                       "%llu of %llu passes (%.1f%%)\n",
+                       hint, s->expr, s->file, (unsigned)s->line, s->func,
+                       (unsigned long long)against, (unsigned long long)n,
+                       100.0 * (double)against / (double)n);
+        }
+        if (csv) {
+            fprintf(csv, "%s,%u,%s,%s,", s->file, (unsigned)s->line, s->func, hint);
+            branch_csv_quoted(csv, s->expr);
+            fprintf(csv, ",%llu,%llu\n", (unsigned long long)n, (unsigned long long)t);
+        }
+    }
+    if (csv) fclose(csv);
+    LOG_PRINTF("[BRANCH] %u of %u hinted sites wrong; per-site counts in %s\n",
+               wrong, sites, csv ? CFG_BRANCH_PROFILE_PATH : "(not written)");
+}
+#endif
+
+/*
+ * Rate-limited logging for conditions that can persist across ticks:
+ *   LOGF_EVERY_N(cond, n, fmt, ...)    1st, (n+1)th, ... pass with cond true
+ *   LOGF_EVERY_MS(cond, ms, fmt, ...)  at most one line per ms milliseconds
+ *   LOGF_ONCE(cond, fmt, ...)          first time cond is true in the run
+ * The statement is evaluated on every pass. While cond holds, lines beyond
+ * the limit are counted; on the first pass where cond is false again, one
+ * "N repeats suppressed" line closes the episode and the limiter rearms.
+ * State is per call site and atomic, so any thread may use a site. A pass
+ * with cond false and no open episode costs one relaxed load.
+ */
+#if CFG_ENABLE_LOGS
+typedef struct {
+    _Atomic uint64_t events;   /* cond-true passes in the open episode */
+    _Atomic uint64_t logged;   /* of which were logged */
+    _Atomic uint64_t next_ns;  /* LOG_LIMIT_MS: earliest time for the next line */
+    _Atomic uint32_t done;     /* LOG_LIMIT_ONCE: already logged in this run */
+} log_limit_t;
+
+enum { LOG_LIMIT_N, LOG_LIMIT_MS, LOG_LIMIT_ONCE };
+
+static inline int log_limit_hit(log_limit_t *l, unsigned kind, uint64_t arg) {
+    uint64_t k = atomic_fetch_add_explicit(&l->events, 1u, memory_order_relaxed);
+    int emit;
+    if (kind == LOG_LIMIT_N) {
+        emit = arg <= 1u || k % arg == 0;
+    } else if (kind == LOG_LIMIT_MS) {
+        uint64_t now = mono_ns(), due = atomic_load_explicit(&l->next_ns, memory_order_relaxed);
+        emit = now >= due &&
+               atomic_compare_exchange_strong_explicit(&l->next_ns, &due, now + arg * 1000000u,
+                                                       memory_order_relaxed, memory_order_relaxed);
+    } else {
+        emit = !atomic_exchange_explicit(&l->done, 1u, memory_order_relaxed);
+    }
+    if (emit) atomic_fetch_add_explicit(&l->logged, 1u, memory_order_relaxed);
+    return emit;
+}
+
+/* Close the open episode; returns how many of its lines were suppressed */
+static NOINLINE uint64_t log_limit_clear(log_limit_t *l) {
+    uint64_t events = atomic_exchange_explicit(&l->events, 0u, memory_order_relaxed);
+    uint64_t logged = atomic_exchange_explicit(&l->logged, 0u, memory_order_relaxed);
+    atomic_store_explicit(&l->next_ns, 0u, memory_order_relaxed);
+    return events > logged ? events - logged : 0u;
+}
+
+#  define LOGF_LIMITED_(cond, kind, arg, fmt, ...) \
+      do { \
+          static log_limit_t _log_limit; \
+          if (UNLIKELY(cond)) { \
+              if (log_limit_hit(&_log_limit, (kind), (uint64_t)(arg))) LOGF(fmt, ##__VA_ARGS__); \
+          } else if (UNLIKELY(atomic_load_explicit(&_log_limit.events, memory_order_relaxed))) { \
+              unsigned long long _sup = (unsigned long long)log_limit_clear(&_log_limit); \
+              if (_sup) LOGF("%llu repeats suppressed (cleared): %s", _sup, fmt); \
+          } \
+      } while (0)
+#  define LOGF_EVERY_N(cond, n, fmt, ...)   LOGF_LIMITED_(cond, LOG_LIMIT_N, n, fmt, ##__VA_ARGS__)
+#  define LOGF_EVERY_MS(cond, ms, fmt, ...) LOGF_LIMITED_(cond, LOG_LIMIT_MS, ms, fmt, ##__VA_ARGS__)
+#  define LOGF_ONCE(cond, fmt, ...)         LOGF_LIMITED_(cond, LOG_LIMIT_ONCE, 0, fmt, ##__VA_ARGS__)
+#else
+#  define LOGF_EVERY_N(cond, n, fmt, ...)   ((void)0)
+#  define LOGF_EVERY_MS(cond, ms, fmt, ...) ((void)0)
+#  define LOGF_ONCE(cond, fmt, ...)         ((void)0)
+#endif
+
+/* ------------------------------------------------------------------
+ * 4b) Live metrics in POSIX shared memory (CFG_METRICS_SHM)
+ *     metrics_open() (section 8) maps CFG_METRICS_SHM_NAME and points
+ *     g_metrics at it; before that, or if it fails, the hooks write a
+ *     private static block, so no hook tests a pointer. Counting is a
+ *     relaxed atomic load and store: no locked instruction, syscall or
+ *     formatting on the loop. The control thread is the only writer
+ *     of every field except errors[], which any thread may count and
+ *     so takes a relaxed fetch-add (error paths only). Readers map the
+ *     name read-only (NASA_METRICS_READER.c) and see each field on its
+ *     own; fields may be a tick apart from each other.
+ *
+ *     lat_hist[b] counts control ticks that took [2^b, 2^(b+1))
+ *     cycles_now() ticks; every METRICS_CLOCK_EVERY ticks the loop also
+ *     stores a (clock_ns, clock_ticks) pair, which against (t0_ns,
+ *     t0_ticks) gives readers the tick length and a heartbeat.
+ * ------------------------------------------------------------------ */
+#if CFG_METRICS_SHM && (defined(__GNUC__) || defined(__clang__))
+#  define METRICS_MAGIC        0x4D53414Eu  /* "NASM" */
+#  define METRICS_VERSION      1u
+#  define METRICS_LAT_BUCKETS  40u
+#  define METRICS_ERR_SLOTS    16u          /* >= ERROR_TABLE + unknown (section 8) */
+#  define METRICS_NAME_LEN     24u
+#  define METRICS_CLOCK_EVERY  1024u        /* power of two */
+
+STATIC_ASSERT(ATOMIC_LLONG_LOCK_FREE == 2, metrics_fields_are_plain_moves);
+
+typedef struct {
+    /* Written by metrics_open() before magic */
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;                           /* sizeof(metrics_block_t) */
+    uint32_t err_slots;                      /* used; the last one is "unknown" */
+    uint64_t pid;
+    uint64_t t0_ticks, t0_ns;
+    char     err_name[METRICS_ERR_SLOTS][METRICS_NAME_LEN];
+    /* Live */
+    CACHELINE_ALIGNED _Atomic uint64_t iterations;
+    _Atomic uint64_t cap_events;             /* SET_THRUST_N / QUEUE_THRUST_N caps */
+    _Atomic uint64_t deadline_misses;        /* scheduler, all tasks */
+    _Atomic uint64_t clock_ticks, clock_ns;
+    _Atomic uint64_t lat_hist[METRICS_LAT_BUCKETS];
+    _Atomic uint64_t errors[METRICS_ERR_SLOTS];
+} metrics_block_t;
+
+static metrics_block_t  g_metrics_local;
+static metrics_block_t *g_metrics = &g_metrics_local;
+
+#  define METRICS_ADD_(field, n) \
+      atomic_store_explicit(&g_metrics->field, \
+                            atomic_load_explicit(&g_metrics->field, memory_order_relaxed) + (n), \
+                            memory_order_relaxed)
+#  define METRICS_COUNT(field) METRICS_ADD_(field, 1u)
+#  define METRICS_ERROR(idx) \
+      ((void)atomic_fetch_add_explicit(&g_metrics->errors[idx], 1u, memory_order_relaxed))
+
+static inline void metrics_loop_end(const uint64_t *t0) {
+    uint64_t dt = cycles_now() - *t0;
+    unsigned b  = dt ? 63u - (unsigned)__builtin_clzll(dt) : 0u;
+    METRICS_ADD_(lat_hist[b < METRICS_LAT_BUCKETS ? b : METRICS_LAT_BUCKETS - 1u], 1u);
+    uint64_t it = atomic_load_explicit(&g_metrics->iterations, memory_order_relaxed) + 1u;
+    atomic_store_explicit(&g_metrics->iterations, it, memory_order_relaxed);
+    if (UNLIKELY((it & (METRICS_CLOCK_EVERY - 1u)) == 0)) {
+        atomic_store_explicit(&g_metrics->clock_ns, mono_ns(), memory_order_relaxed);
+        atomic_store_explicit(&g_metrics->clock_ticks, cycles_now(), memory_order_relaxed);
+    }
+}
+
+/* First statement of a control tick: counts it and its duration on exit */
+#  define METRICS_LOOP_SCOPE() \
+      __attribute__((cleanup(metrics_loop_end))) const uint64_t PP_CAT(_metrics_t0_, __LINE__) = \
+          cycles_now()
+#else
+#  define METRICS_COUNT(field) ((void)0)
+#  define METRICS_ERROR(idx)   ((void)0)
+#  define METRICS_LOOP_SCOPE() ((void)0)
+#endif
+
+/* ------------------------------------------------------------------
+ * 5) Multi-statement macros (statement-safe)
+ * ------------------------------------------------------------------ */
+#define SCOPE_DO(block) do { block } while (0)
+
+/* Type-generic swap of two lvalues of the same type (each named twice) */
+#if defined(__GNUC__) || defined(__clang__)
+#  define SWAP(a, b) \
+      SCOPE_DO({ \
+          STATIC_ASSERT(__builtin_types_compatible_p(__typeof__(a), __typeof__(b)), swap_same_type); \
+          __typeof__(a) _swap_t = (a); \
+          (a) = (b); \
+          (b) = _swap_t; \
+      })
+#else
+#  define SWAP(a, b) \
+      SCOPE_DO({ \
+          unsigned char _swap_t[sizeof(a) == sizeof(b) ? sizeof(a) : -1]; \
+          memcpy(_swap_t, &(a), sizeof _swap_t); \
+          memcpy(&(a), &(b), sizeof _swap_t); \
+          memcpy(&(b), _swap_t, sizeof _swap_t); \
+      })
+#endif
+
+#if CFG_ENABLE_ASSERTS
+#  include <assert.h>
+#endif
+
+#if CFG_OUTLINE_FAILURES
+/*
+ * Outlined failure paths: a call site keeps only the compare and one
+ * branch; everything else lives in shared NOINLINE/COLD handlers that get
+ * the site's registry descriptor (section 4; text = the stringized call
+ * or assertion). Messages are byte-for-byte those of the inline expansion
+ * (CFG_OUTLINE_FAILURES=0), which is kept for comparison; see
+ * COLD_PATH_BENCH.c.
+ */
+#  if CFG_ENABLE_LOGS && CFG_LOG_BINARY
+#    define FAIL_LOG(site, fmt, n, ...) \
+         log_bin_emit(site_id(site), (n), (const uint64_t[]){ __VA_ARGS__ })
+#  elif CFG_ENABLE_LOGS
+#    define FAIL_LOG(site, fmt, n, ...) \
+         LOG_PRINTF("[LOG] %s:%d %s(): " fmt "\n", (site)->file, (int)(site)->line, (site)->func, \
+                    PP_CAT(FAIL_ARGS_, n)(__VA_ARGS__))
+#    define FAIL_ARGS_1(a)    (const char *)(uintptr_t)(a)
+#    define FAIL_ARGS_2(a, b) FAIL_ARGS_1(a), (int)(b)
+#  else
+#    define FAIL_LOG(site, fmt, n, ...) ((void)(site))
+#  endif
+
+static NOINLINE COLD NORETURN void safe_call_failed(const site_t *site, int rc) {
+    FAIL_LOG(site, SAFE_CALL_FMT, 2, (uint64_t)(uintptr_t)site->text, (uint64_t)rc);
+    (void)rc;
+    LOG_SINK_FLUSH();
+    exit(EXIT_FAILURE);
+}
+
+#  if CFG_ENABLE_ASSERTS
+/* Returns only under NDEBUG, where assert() would have been a no-op too. */
+#    ifndef NDEBUG
+NORETURN
+#    endif
+static NOINLINE COLD void assert_failed(const site_t *site) {
+    FAIL_LOG(site, ASSERT_FMT, 1, (uint64_t)(uintptr_t)site->text);
+    LOG_SINK_FLUSH();
+#    ifndef NDEBUG
+#      if defined(__GLIBC__)
+    __assert_fail(site->text, site->file, site->line, site->func);
+#      else
+    fprintf(stderr, "%s:%u: %s: Assertion `%s' failed.\n", site->file, (unsigned)site->line, site->func,
+            site->text);
+    abort();
+#      endif
+#    endif
+}
+#  endif
+
+#  define SAFE_CALL(call) \
+      SCOPE_DO({ \
+          int _rc = (call); \
+          if (UNLIKELY(_rc != 0)) { \
+              SITE_DEFINE(_fail_site, SITE_SAFE_CALL, #call); \
+              safe_call_failed(&_fail_site, _rc); \
+          } \
+      })
+#else
+#  define SAFE_CALL(call) \
+      SCOPE_DO({ \
+          int _rc = (call); \
+          if (UNLIKELY(_rc != 0)) { \
+              LOGF(SAFE_CALL_FMT, #call, _rc); \
+              LOG_SINK_FLUSH(); \
+              exit(EXIT_FAILURE); \
+          } \
+      })
+#endif
+
+/* Simple runtime assert gated by config */
+#if CFG_ENABLE_ASSERTS && CFG_OUTLINE_FAILURES
+#  define ASSERT(x) \
+      SCOPE_DO({ \
+          if (UNLIKELY(!(x))) { \
+              SITE_DEFINE(_fail_site, SITE_ASSERT, #x); \
+              assert_failed(&_fail_site); \
+          } \
+      })
+#elif CFG_ENABLE_ASSERTS
+#  define ASSERT(x) SCOPE_DO({ if(!(x)){ LOGF(ASSERT_FMT, #x); LOG_SINK_FLUSH(); assert(x); } })
+#else
+#  define ASSERT(x) ((void)0)
+#endif
+
+/* ------------------------------------------------------------------
+ * 5b) Static pools and arenas (no-malloc allocation)
+ *     POOL_DEFINE(var, type, n) gives n fixed-size objects with
+ *     var_alloc()/var_free(); ARENA_DEFINE(var, bytes) gives a bump
+ *     allocator with ARENA_NEW(var, type, n) and arena_reset(). Storage
+ *     is static and cache-line aligned, sizes are checked at compile
+ *     time, and both are lock-free: any thread may alloc or free. With
+ *     CFG_POOL_STATS, POOL_LOG_STATS/ARENA_LOG_STATS report high-water
+ *     marks for sizing.
+ *
+ *     The pool's free list is a Treiber stack of slot indices whose head
+ *     carries a version tag against ABA; slots never handed out before
+ *     come from a bump counter, so a zero-initialized pool is ready.
+ * ------------------------------------------------------------------ */
+#define POOL_MAX_COUNT   0x7FFFFFFFu
+
+typedef struct {
+    _Atomic uint64_t  head;      /* (version << 32) | (slot index + 1), 0 = empty */
+    _Atomic uint32_t  fresh;     /* slots below this were handed out at least once */
+    _Atomic uint32_t *next;      /* free-list links, one per slot */
+    unsigned char    *base;
+    uint32_t          size;      /* bytes per slot */
+    uint32_t          count;
+    const char       *name;
+#if CFG_POOL_STATS
+    CACHELINE_ALIGNED                /* counters off the free-list head's line */
+    _Atomic uint32_t  used;
+    _Atomic uint32_t  high_water;
+    _Atomic uint64_t  exhausted; /* allocs that returned NULL */
+#endif
+} pool_t;
+
+typedef struct {
+    _Atomic size_t    top;
+    unsigned char    *base;
+    size_t            cap;
+    const char       *name;
+#if CFG_POOL_STATS
+    _Atomic size_t    high_water;
+    _Atomic uint64_t  exhausted;
+#endif
+} arena_t;
+
+#if CFG_POOL_STATS
+static inline void pool_note_max(_Atomic uint32_t *hw, uint32_t v) {
+    uint32_t cur = atomic_load_explicit(hw, memory_order_relaxed);
+    while (v > cur && !atomic_compare_exchange_weak_explicit(hw, &cur, v, memory_order_relaxed,
+                                                             memory_order_relaxed)) {}
+}
+#endif
+
+static inline void *pool_alloc(pool_t *p) {
+    uint32_t i;
+    uint64_t h = atomic_load_explicit(&p->head, memory_order_acquire);
+    for (;;) {
+        if ((uint32_t)h == 0) {
+            i = atomic_load_explicit(&p->fresh, memory_order_relaxed);
+            do {
+                if (UNLIKELY(i >= p->count)) {
+#if CFG_POOL_STATS
+                    atomic_fetch_add_explicit(&p->exhausted, 1, memory_order_relaxed);
+#endif
+                    return NULL;
+                }
+            } while (!atomic_compare_exchange_weak_explicit(&p->fresh, &i, i + 1u,
+                                                            memory_order_relaxed,
+                                                            memory_order_relaxed));
+            break;
+        }
+        i = (uint32_t)h - 1u;
+        uint64_t nh = ((h >> 32) + 1u) << 32 |
+                      atomic_load_explicit(&p->next[i], memory_order_relaxed);
+        if (atomic_compare_exchange_weak_explicit(&p->head, &h, nh, memory_order_acquire,
+                                                  memory_order_acquire)) break;
+    }
+#if CFG_POOL_STATS
+    pool_note_max(&p->high_water,
+                  atomic_fetch_add_explicit(&p->used, 1, memory_order_relaxed) + 1u);
+#endif
+    return p->base + (size_t)i * p->size;
+}
+
+static inline void pool_free(pool_t *p, void *obj) {
+    if (!obj) return;
+    size_t off = (size_t)((unsigned char *)obj - p->base);
+    ASSERT(off < (size_t)p->count * p->size && off % p->size == 0);
+    uint32_t i = (uint32_t)(off / p->size);
+#if CFG_POOL_STATS
+    atomic_fetch_sub_explicit(&p->used, 1, memory_order_relaxed); /* before the push: used <= count */
+#endif
+    uint64_t h = atomic_load_explicit(&p->head, memory_order_relaxed);
+    do {
+        atomic_store_explicit(&p->next[i], (uint32_t)h, memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(&p->head, &h, ((h >> 32) + 1u) << 32 | (i + 1u),
+                                                    memory_order_release, memory_order_relaxed));
+}
+
+/* Bump allocation; align must be a power of two <= CACHELINE_SIZE */
+static inline void *arena_alloc(arena_t *a, size_t size, size_t align) {
+    size_t top = atomic_load_explicit(&a->top, memory_order_relaxed), start, end;
+    do {
+        start = (top + align - 1u) & ~(align - 1u);
+        end   = start + size;
+        if (UNLIKELY(end > a->cap || end < start)) {
+#if CFG_POOL_STATS
+            atomic_fetch_add_explicit(&a->exhausted, 1, memory_order_relaxed);
+#endif
+            return NULL;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&a->top, &top, end, memory_order_relaxed,
+                                                    memory_order_relaxed));
+#if CFG_POOL_STATS
+    size_t hw = atomic_load_explicit(&a->high_water, memory_order_relaxed);
+    while (end > hw && !atomic_compare_exchange_weak_explicit(&a->high_water, &hw, end,
+                                                              memory_order_relaxed,
+                                                              memory_order_relaxed)) {}
+#endif
+    return a->base + start;
+}
+
+/* Release everything at once; callers must be done with the arena */
+static inline void arena_reset(arena_t *a) { atomic_store_explicit(&a->top, 0, memory_order_relaxed); }
+
+#define POOL_DEFINE(var, type, n) \
+    STATIC_ASSERT((n) >= 1 && (n) <= POOL_MAX_COUNT, pool_##var##_count); \
+    STATIC_ASSERT(sizeof(type) <= 0xFFFFFFFFu, pool_##var##_object_size); \
+    static CACHELINE_ALIGNED type var##_storage[n]; \
+    static _Atomic uint32_t var##_next[n]; \
+    static pool_t var = { .next = var##_next, .base = (unsigned char *)var##_storage, \
+                          .size = sizeof(type), .count = (n), .name = #var }; \
+    static inline type *var##_alloc(void) { return (type *)pool_alloc(&var); } \
+    static inline void var##_free(type *obj) { pool_free(&var, obj); }
+
+#define ARENA_DEFINE(var, bytes) \
+    STATIC_ASSERT((bytes) >= 1, arena_##var##_size); \
+    static CACHELINE_ALIGNED unsigned char var##_storage[bytes]; \
+    static arena_t var = { .base = var##_storage, .cap = (bytes), .name = #var }
+
+#define ARENA_NEW(var, type, n) \
+    ((type *)arena_alloc(&(var), sizeof(type) * (size_t)(n), _Alignof(type)))
+
+#if CFG_POOL_STATS
+#  define POOL_LOG_STATS(p) \
+      LOGF("Pool %s: %u/%u in use, high-water %u, %llu exhausted", (p).name, \
+           (unsigned)atomic_load(&(p).used), (unsigned)(p).count, \
+           (unsigned)atomic_load(&(p).high_water), (unsigned long long)atomic_load(&(p).exhausted))
+#  define ARENA_LOG_STATS(a) \
+      LOGF("Arena %s: %zu/%zu bytes in use, high-water %zu, %llu exhausted", (a).name, \
+           (size_t)atomic_load(&(a).top), (a).cap, (size_t)atomic_load(&(a).high_water), \
+           (unsigned long long)atomic_load(&(a).exhausted))
+#else
+#  define POOL_LOG_STATS(p)  ((void)0)
+#  define ARENA_LOG_STATS(a) ((void)0)
+#endif
+
+/* ------------------------------------------------------------------
+ * 5c) Byte order: bulk in-place endian conversion
+ *     BSWAP_BUFFER(ptr, n, width) reverses the bytes of each of n
+ *     width-bit words (width: literal 16, 32 or 64) in place, one vector
+ *     per step: pshufb (AVX2/SSSE3), shifts and word shuffles (SSE2) or
+ *     NEON rev16/rev32/rev64. Other targets and the tail use the bswap
+ *     builtins, or SWAP byte pairs without them. Register dumps recorded
+ *     on a big-endian host convert at memory bandwidth (BSWAP_BENCH.c).
+ * ------------------------------------------------------------------ */
+static ALWAYS_INLINE void bswap_words_(uint8_t *p, size_t n, unsigned w) {
+    const size_t len = n * w;
+    size_t i = 0;
+#if defined(__AVX2__) || defined(__SSSE3__)
+    /* pshufb control: byte k of each word comes from byte w-1-k */
+    static const uint8_t rev2[16] = { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 };
+    static const uint8_t rev4[16] = { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 };
+    static const uint8_t rev8[16] = { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 };
+    const __m128i ctl = _mm_loadu_si128((const __m128i *)(w == 2u ? rev2 : w == 4u ? rev4 : rev8));
+#  if defined(__AVX2__)
+    const __m256i ctl2 = _mm256_broadcastsi128_si256(ctl);
+    for (; i + 64u <= len; i += 64u) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(p + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(p + i + 32u));
+        _mm256_storeu_si256((__m256i *)(p + i), _mm256_shuffle_epi8(a, ctl2));
+        _mm256_storeu_si256((__m256i *)(p + i + 32u), _mm256_shuffle_epi8(b, ctl2));
+    }
+#  endif
+    for (; i + 16u <= len; i += 16u) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        _mm_storeu_si128((__m128i *)(p + i), _mm_shuffle_epi8(v, ctl));
+    }
+#elif defined(__SSE2__)
+    for (; i + 16u <= len; i += 16u) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        if (w == 4u) {        /* swap the 16-bit halves, then the bytes in each */
+            v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        } else if (w == 8u) { /* reverse the four 16-bit words, then the bytes */
+            v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+        }
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128((__m128i *)(p + i), v);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 16u <= len; i += 16u) {
+        uint8x16_t v = vld1q_u8(p + i);
+        vst1q_u8(p + i, w == 2u ? vrev16q_u8(v) : w == 4u ? vrev32q_u8(v) : vrev64q_u8(v));
+    }
+#endif
+    for (; i < len; i += w) {  /* tail (or whole buffer without SIMD) */
+#if defined(__GNUC__) || defined(__clang__)
+        if (w == 2u) {
+            uint16_t v; memcpy(&v, p + i, 2); v = __builtin_bswap16(v); memcpy(p + i, &v, 2);
+        } else if (w == 4u) {
+            uint32_t v; memcpy(&v, p + i, 4); v = __builtin_bswap32(v); memcpy(p + i, &v, 4);
+        } else {
+            uint64_t v; memcpy(&v, p + i, 8); v = __builtin_bswap64(v); memcpy(p + i, &v, 8);
+        }
+#else
+        for (unsigned k = 0; k < w / 2u; ++k) SWAP(p[i + k], p[i + w - 1u - k]);
+#endif
+    }
+}
+
+static inline void bswap_buffer_16(void *p, size_t n) { bswap_words_((uint8_t *)p, n, 2u); }
+static inline void bswap_buffer_32(void *p, size_t n) { bswap_words_((uint8_t *)p, n, 4u); }
+static inline void bswap_buffer_64(void *p, size_t n) { bswap_words_((uint8_t *)p, n, 8u); }
+
+#define BSWAP_BUFFER(ptr, n, width) bswap_buffer_##width((ptr), (n))
+
+/* ------------------------------------------------------------------
+ * 6) Hardware registers (simulated or memory-mapped)
+ *    With SIM_HW_REGS the register file is a struct in RAM so the demo
+ *    runs on any host; without it, hw_map() maps the device's register
+ *    window and the same struct overlays it.
+ * ------------------------------------------------------------------ */
+/*
+ * Register map, in address order: X(name, description, tlm_delta_bits).
+ * The last column is the width of a "small change" in the telemetry
+ * frames of section 11; see TLM_FRAME_BYTES.
+ */
+#define HW_REG_TABLE \
+    X(CTRL,      "control register",  2) \
+    X(STATUS,    "status register",   4) \
+    X(THRUST,    "thrust (Newtons)",  9) \
+    X(SENS_TEMP, "temp sensor (raw)", 5)
+
+/*
+ * Sensor channel bank, one 32-bit raw ADC register per channel straight
+ * after SENS_TEMP, in table order: X(name, description, gain_q8,
+ * offset_q8), where degC = (raw * gain_q8 + offset_q8) / 256 for a
+ * 12-bit raw value. Section 7 pastes each name into its register
+ * SENS_<name>, constants, accessor and reader; these registers are
+ * hardware-owned and not part of the snapshot or telemetry frames.
+ */
+#define SENSOR_CHANNELS \
+    X(OX_TANK,   "oxidizer tank",   16, -51200) \
+    X(FUEL_TANK, "fuel tank",       16, -12800) \
+    X(CHAMBER,   "chamber wall",   256,      0) \
+    X(NOZZLE,    "nozzle throat",  512,  -2560) \
+    X(AVIONICS,  "avionics bay",    16, -12800)
+
+#if defined(SIM_HW_REGS) && CFG_SPLIT_REGS
+#  define HW_REG_LAYOUT CACHELINE_ALIGNED   /* one line per register */
+#  define HW_WINDOW_PACKED 0
+#else
+#  define HW_REG_LAYOUT                     /* packed, as on the bus */
+#  define HW_WINDOW_PACKED 1
+#endif
+#if defined(SIM_HW_REGS) && CFG_ACT_PIPELINE
+#  define SIM_ACT_FIFO 64u                  /* >= CFG_ACT_INFLIGHT */
+#endif
+typedef struct {
+#define X(name, desc, dbits) HW_REG_LAYOUT volatile uint32_t name;
+    HW_REG_TABLE
+#undef X
+#define X(name, desc, gain_q8, offset_q8) HW_REG_LAYOUT volatile uint32_t SENS_##name;
+    SENSOR_CHANNELS
+#undef X
+#if defined(SIM_HW_REGS) && CFG_SENSOR_WAIT
+    /* Simulated "new sample" interrupt (section 7): count and sleepers */
+    _Atomic uint32_t sens_irq;
+    _Atomic uint32_t sens_waiters;
+#endif
+#if defined(SIM_HW_REGS) && CFG_ACT_PIPELINE
+    /* Simulated actuators (section 7c): latched commands not yet applied */
+    struct {
+        uint32_t ctrl[SIM_ACT_FIFO];
+        uint64_t due_ns[SIM_ACT_FIFO];
+        uint32_t head, tail;
+    } sim_act;
+#endif
+} hw_regs_t;
+
+#ifdef SIM_HW_REGS
+static hw_regs_t HW = {0};
+
+/*
+ * Each thread drives one register file at a time: HW unless it binds
+ * another instance (one per simulated vehicle, see SIM_FARM.c). The
+ * control functions are unchanged; they reach whatever is bound.
+ */
+static _Thread_local hw_regs_t *hw_cur = &HW;
+static _Thread_local uint32_t   hw_bind_epoch;  /* bumped by every hw_bind() */
+
+/* Bind r (NULL = HW) to the calling thread; returns the previous binding */
+static inline hw_regs_t *hw_bind(hw_regs_t *r) {
+    hw_regs_t *prev = hw_cur;
+    hw_cur = r ? r : &HW;
+    hw_bind_epoch++;
+    return prev;
+}
+#  define REG32(name)     (hw_cur->name)
+#else
+/*
+ * Real registers: hw_map() (first thing in init_system) maps the window
+ * once, CFG_HW_MAP_OFFSET bytes into CFG_HW_DEV, and every register is
+ * then a fixed offset from that base. For a UIO device, map N sits at
+ * offset N * page size; for /dev/mem, give the window's physical
+ * address. The mapping lives until exit.
+ */
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+
+static hw_regs_t *hw_cur;
+
+static int hw_map(void) {
+    if (hw_cur) return 0;
+    int fd = open(CFG_HW_DEV, O_RDWR | O_SYNC | O_CLOEXEC);
+    if (fd < 0) return -1;
+    uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+    uint64_t base = (uint64_t)CFG_HW_MAP_OFFSET & ~(page - 1u);
+    size_t   skew = (size_t)((uint64_t)CFG_HW_MAP_OFFSET - base);
+    void *p = mmap(NULL, skew + sizeof(hw_regs_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, (off_t)base);
+    close(fd);
+    if (p == MAP_FAILED) return -1;
+    hw_cur = (hw_regs_t *)((char *)p + skew);
+    return 0;
+}
+#  define REG32(name)     (hw_cur->name)
+#endif
+
+/* Thrust-cap warnings repeat at most this often during a saturation */
+#define LOG_CAP_INTERVAL_MS 1000u
+
+/* Bit fields for CTRL */
+#define CTRL_ENABLE   (1u<<0)
+#define CTRL_FAULT    (1u<<1)
+
+/*
+ * Actuator command handshake (section 7c). Writing CTRL with a new
+ * CMD_SEQ is the doorbell: the actuators latch THRUST for channel CMD_CH.
+ * STATUS.ACK_SEQ is the sequence number of the last command they applied;
+ * commands complete in order, so one value acknowledges all before it.
+ */
+#define CTRL_CMD_SEQ_SHIFT    8
+#define CTRL_CMD_CH_SHIFT     16
+#define CTRL_CMD_MASK         (0xFFu << CTRL_CMD_SEQ_SHIFT | 0x3Fu << CTRL_CMD_CH_SHIFT)
+#define STATUS_ACK_SEQ_SHIFT  8
+#define STATUS_ACK_SEQ_MASK   (0xFFu << STATUS_ACK_SEQ_SHIFT)
+
+/*
+ * Software-owned register access. With CFG_SHADOW_REGS, REG_PUT lands in
+ * a RAM shadow: writes that don't change the value are dropped, repeated
+ * writes within a tick collapse, and REG_FLUSH() emits the dirty registers
+ * in SHADOW_REG_TABLE order as one burst. REG_GET reads the shadow, so
+ * read-modify-write never touches the bus. Only registers the flight
+ * software alone writes belong in the table; hardware-owned ones
+ * (STATUS, SENS_TEMP) are always read through REG32. THRUST goes before
+ * CTRL, which can carry the actuator doorbell (section 7c).
+ */
+#define SHADOW_REG_TABLE \
+    X(THRUST) \
+    X(CTRL)
+
+#if CFG_SHADOW_REGS
+enum {
+#define X(name) SHADOW_IDX_##name,
+    SHADOW_REG_TABLE
+#undef X
+    SHADOW_COUNT
+};
+
+typedef struct {
+    uint32_t val[SHADOW_COUNT];
+    uint32_t dirty;              /* bit i = val[i] not yet on the bus */
+    uint64_t puts;               /* REG_PUT calls */
+    uint64_t skipped;            /* value unchanged: no bus write needed */
+    uint64_t coalesced;          /* overwrote a still-pending write */
+    uint64_t bus_writes;         /* writes actually issued by REG_FLUSH */
+} shadow_regs_t;
+
+static _Thread_local shadow_regs_t g_shadow; /* shadows the thread's bound register file */
+
+/* Adopt the current hardware values (call once before the first REG_PUT). */
+static void shadow_sync(void) {
+#define X(name) g_shadow.val[SHADOW_IDX_##name] = REG32(name);
+    SHADOW_REG_TABLE
+#undef X
+    g_shadow.dirty = 0;
+}
+
+static inline void shadow_put(unsigned idx, uint32_t v) {
+    uint32_t bit = 1u << idx;
+    ++g_shadow.puts;
+    if (g_shadow.val[idx] == v) { g_shadow.skipped += !(g_shadow.dirty & bit); return; }
+    g_shadow.coalesced += (g_shadow.dirty & bit) != 0;
+    g_shadow.val[idx] = v;
+    g_shadow.dirty |= bit;
+}
+
+static inline void shadow_flush(void) {
+    uint32_t dirty = g_shadow.dirty;
+    if (!dirty) return;
+#define X(name) \
+    if (dirty & (1u << SHADOW_IDX_##name)) { REG32(name) = g_shadow.val[SHADOW_IDX_##name]; ++g_shadow.bus_writes; }
+    SHADOW_REG_TABLE
+#undef X
+    g_shadow.dirty = 0;
+    atomic_thread_fence(memory_order_seq_cst); /* burst is visible before we go on */
+}
+
+#  define REG_GET(name)    (g_shadow.val[SHADOW_IDX_##name])
+#  define REG_PUT(name, v) shadow_put(SHADOW_IDX_##name, (uint32_t)(v))
+#  define REG_FLUSH()      shadow_flush()
+#  define REG_SYNC()       shadow_sync()
+#else
+#  define REG_GET(name)    REG32(name)
+#  define REG_PUT(name, v) ((void)(REG32(name) = (uint32_t)(v)))
+#  define REG_FLUSH()      ((void)0)
+#  define REG_SYNC()       ((void)0)
+#endif
+
+/*
+ * Consistent register snapshots for other threads (seqlock). The control
+ * loop calls hw_snapshot_publish() once per tick with the registers it
+ * burst-read after its flush; readers
+ * on any thread call hw_snapshot_read() and get all HW_REG_TABLE fields
+ * from the same tick. The writer never waits: it bumps the sequence to
+ * odd, stores the fields and bumps it to even. A reader that overlaps a
+ * publish sees the sequence move and retries. Fields are relaxed atomics,
+ * so the stores are plain moves. Only the HW instance is published;
+ * vehicles bound with hw_bind() in a farm have no readers.
+ */
+typedef struct {
+#define X(name, desc, dbits) uint32_t name;
+    HW_REG_TABLE
+#undef X
+} hw_snapshot_t;
+
+#ifndef SIM_HW_REGS
+#define X(name, desc, gain_q8, offset_q8) + sizeof(uint32_t)
+STATIC_ASSERT(sizeof(hw_regs_t) == sizeof(hw_snapshot_t) SENSOR_CHANNELS, hw_window_is_the_packed_table);
+#undef X
+#endif
+
+/*
+ * All HW_REG_TABLE registers at once, for the end-of-tick publish and
+ * fault check and for telemetry. On a packed window each 16 bytes come
+ * in with one load (movdqu on x86-64, ldp on AArch64), so CTRL, STATUS,
+ * THRUST and SENS_TEMP cost one bus read instead of four REG32 reads.
+ * Whether the interconnect keeps a 16-byte load as one transaction is
+ * up to the platform; it never splits below the four word accesses.
+ * The split simulated layout and other hosts read field by field.
+ */
+static inline void hw_load16(void *dst, const volatile void *src) {
+    typedef struct { unsigned char b[16]; } hw_line16_t;
+#if defined(__x86_64__)
+    __m128i v;
+    __asm__ __volatile__("movdqu %1, %0" : "=x"(v) : "m"(*(const hw_line16_t *)src));
+    memcpy(dst, &v, sizeof v);
+#elif defined(__aarch64__)
+    uint64_t v[2];
+    __asm__ __volatile__("ldp %0, %1, %2" : "=r"(v[0]), "=r"(v[1]) : "Q"(*(const hw_line16_t *)src));
+    memcpy(dst, v, sizeof v);
+#else
+    const volatile uint32_t *w = src;
+    uint32_t v[4] = { w[0], w[1], w[2], w[3] };
+    memcpy(dst, v, sizeof v);
+#endif
+}
+
+static inline void hw_burst_read(hw_snapshot_t *out) {
+#if HW_WINDOW_PACKED
+    const volatile unsigned char *src = (const volatile unsigned char *)hw_cur;
+    unsigned char *dst = (unsigned char *)out;
+    size_t i = 0;
+    for (; i + 16u <= sizeof *out; i += 16u) hw_load16(dst + i, src + i);
+    for (; i < sizeof *out; i += 4u) {
+        uint32_t w = *(const volatile uint32_t *)(src + i);
+        memcpy(dst + i, &w, sizeof w);
+    }
+#else
+#define X(name, desc, dbits) out->name = REG32(name);
+    HW_REG_TABLE
+#undef X
+#endif
+}
+
+static struct {
+    CACHELINE_ALIGNED _Atomic uint32_t seq;   /* odd while a publish is in progress */
+#define X(name, desc, dbits) _Atomic uint32_t name;
+    HW_REG_TABLE
+#undef X
+} g_hw_snap;
+
+/* r: this tick's registers, from hw_burst_read() */
+static inline void hw_snapshot_publish(const hw_snapshot_t *r) {
+#ifdef SIM_HW_REGS
+    if (hw_cur != &HW) return;
+#endif
+    uint32_t s = atomic_load_explicit(&g_hw_snap.seq, memory_order_relaxed);
+    atomic_store_explicit(&g_hw_snap.seq, s + 1u, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+#define X(name, desc, dbits) atomic_store_explicit(&g_hw_snap.name, r->name, memory_order_relaxed);
+    HW_REG_TABLE
+#undef X
+    atomic_store_explicit(&g_hw_snap.seq, s + 2u, memory_order_release);
+}
+
+/* Latest published registers into *out; returns the publish count (0 = none yet) */
+static inline uint32_t hw_snapshot_read(hw_snapshot_t *out) {
+    uint32_t s0, s1;
+    do {
+        s0 = atomic_load_explicit(&g_hw_snap.seq, memory_order_acquire);
+#define X(name, desc, dbits) out->name = atomic_load_explicit(&g_hw_snap.name, memory_order_relaxed);
+        HW_REG_TABLE
+#undef X
+        atomic_thread_fence(memory_order_acquire);
+        s1 = atomic_load_explicit(&g_hw_snap.seq, memory_order_relaxed);
+    } while (UNLIKELY((s0 & 1u) || s0 != s1));
+    return s0 / 2u;
+}
+
+/* Enabling is deferred to the tick flush; disable/fault go out at once. */
+#define ENABLE_SYSTEM()  SCOPE_DO({ REG_PUT(CTRL, REG_GET(CTRL) | CTRL_ENABLE);  LOGF("System ENABLED"); })
+#define DISABLE_SYSTEM() SCOPE_DO({ REG_PUT(CTRL, REG_GET(CTRL) & ~CTRL_ENABLE); REG_FLUSH(); LOGF("System DISABLED"); })
+#define SIGNAL_FAULT()   SCOPE_DO({ REG_PUT(CTRL, REG_GET(CTRL) | CTRL_FAULT);   REG_FLUSH(); LOGF("FAULT signaled"); })
+
+/* Thrust command with safety cap `limit`; `put` consumes the capped value _n */
+#define THRUST_CAPPED_(newton, limit, put, done_fmt) \
+    SCOPE_DO({ \
+        uint32_t _n = (uint32_t)(newton); \
+        LOGF_EVERY_MS(_n > (limit), LOG_CAP_INTERVAL_MS, \
+                      "Thrust request %u exceeds limit %u — capping", _n, (unsigned)(limit)); \
+        if (UNLIKELY(_n > (limit))) { _n = (limit); METRICS_COUNT(cap_events); } \
+        put; \
+        LOGF(done_fmt, _n); \
+    })
+#define SET_THRUST_N(newton) \
+    THRUST_CAPPED_(newton, CFG_MAX_THRUST_N, REG_PUT(THRUST, _n), "THRUST set to %u N")
+
+/* ------------------------------------------------------------------
+ * 7) Platform/arch abstraction (sensor read)
+ * ------------------------------------------------------------------ */
+static inline int read_sensor_riscv(int *out) { *out = (int)REG32(SENS_TEMP); return 0; }
+static inline int read_sensor_arm  (int *out) { *out = (int)REG32(SENS_TEMP); return 0; }
+
+#if defined(CPU_ARM)
+#  define READ_SENSOR_ARCH read_sensor_arm
+#elif defined(CPU_RISCV)
+#  define READ_SENSOR_ARCH read_sensor_riscv
+#endif
+
+/*
+ * Calibration: piecewise-linear lookup of the cubic curve, generated at
+ * compile time into .rodata. 64 segments of 64 counts each cover the
+ * 12-bit raw range; values are Q8 fixed point (1/256 degC), so a sample
+ * costs one table pair, a multiply and two shifts. Worst-case deviation
+ * from the polynomial is ~0.01 degC for the default curve. Raw values
+ * outside 0..4095 are clamped.
+ */
+#define TEMP_CAL_RAW_MAX    4095
+#define TEMP_CAL_SEG_SHIFT  6
+#define TEMP_CAL_SEGMENTS   ((TEMP_CAL_RAW_MAX + 1) >> TEMP_CAL_SEG_SHIFT)
+
+#define TEMP_CAL_POLY(r) \
+    (CFG_TEMP_CAL_C0 + (r) * (CFG_TEMP_CAL_C1 + (r) * (CFG_TEMP_CAL_C2 + (r) * CFG_TEMP_CAL_C3)))
+#define TEMP_CAL_Q8(x)   ((int32_t)((x) * 256.0 + ((x) >= 0 ? 0.5 : -0.5)))
+#define TEMP_CAL_AT(i)   TEMP_CAL_Q8(TEMP_CAL_POLY((double)((i) << TEMP_CAL_SEG_SHIFT)))
+#define TEMP_CAL_SLOPE(i) (TEMP_CAL_AT((i) + 1) - TEMP_CAL_AT(i))
+
+#define REP8(M, b)  M(b) M(b + 1) M(b + 2) M(b + 3) M(b + 4) M(b + 5) M(b + 6) M(b + 7)
+#define REP64(M)    REP8(M, 0) REP8(M, 8) REP8(M, 16) REP8(M, 24) \
+                    REP8(M, 32) REP8(M, 40) REP8(M, 48) REP8(M, 56)
+#define TEMP_CAL_BASE_E(i)  TEMP_CAL_AT(i),
+#define TEMP_CAL_SLOPE_E(i) TEMP_CAL_SLOPE(i),
+
+STATIC_ASSERT(TEMP_CAL_SEGMENTS == 64, temp_cal_table_is_rep64);
+
+/* Segment start values and per-segment deltas (Q8 degC) */
+static const int32_t temp_cal_base[TEMP_CAL_SEGMENTS]  = { REP64(TEMP_CAL_BASE_E) };
+static const int32_t temp_cal_slope[TEMP_CAL_SEGMENTS] = { REP64(TEMP_CAL_SLOPE_E) };
+
+static inline int32_t temp_cal_q8(int32_t raw) {
+    raw = raw < 0 ? 0 : raw > TEMP_CAL_RAW_MAX ? TEMP_CAL_RAW_MAX : raw;
+    int32_t i = raw >> TEMP_CAL_SEG_SHIFT, f = raw & ((1 << TEMP_CAL_SEG_SHIFT) - 1);
+    return temp_cal_base[i] + ((temp_cal_slope[i] * f) >> TEMP_CAL_SEG_SHIFT);
+}
+
+/* Q8 -> whole degC, rounding half up */
+static inline int32_t temp_cal_c(int32_t raw) { return (temp_cal_q8(raw) + 128) >> 8; }
+
+/* Batch conversion for many channels: raw[0..n) -> out_c[0..n) in degC. */
+static void temp_cal_batch(const int32_t *raw, int32_t *out_c, unsigned n) {
+    unsigned i = 0;
+#if defined(__AVX2__)
+    const __m256i lo   = _mm256_setzero_si256();
+    const __m256i hi   = _mm256_set1_epi32(TEMP_CAL_RAW_MAX);
+    const __m256i fmsk = _mm256_set1_epi32((1 << TEMP_CAL_SEG_SHIFT) - 1);
+    const __m256i half = _mm256_set1_epi32(128);
+    for (; i + 8u <= n; i += 8u) {
+        __m256i r  = _mm256_min_epi32(_mm256_max_epi32(_mm256_loadu_si256((const __m256i *)(raw + i)), lo), hi);
+        __m256i ix = _mm256_srli_epi32(r, TEMP_CAL_SEG_SHIFT);
+        __m256i b  = _mm256_i32gather_epi32((const int *)temp_cal_base, ix, 4);
+        __m256i d  = _mm256_i32gather_epi32((const int *)temp_cal_slope, ix, 4);
+        __m256i q8 = _mm256_add_epi32(b, _mm256_srai_epi32(
+                         _mm256_mullo_epi32(d, _mm256_and_si256(r, fmsk)), TEMP_CAL_SEG_SHIFT));
+        _mm256_storeu_si256((__m256i *)(out_c + i), _mm256_srai_epi32(_mm256_add_epi32(q8, half), 8));
+    }
+#endif
+    for (; i < n; ++i) out_c[i] = temp_cal_c(raw[i]); /* no gather: scalar, auto-vectorizable */
+}
+
+/* READ_TEMP_RAW: arch read, then calibration when CFG_TEMP_CAL is on */
+static inline int read_temp_calibrated(int (*rd)(int *), int *out) {
+    int rc = rd(out);
+    if (LIKELY(rc == 0)) *out = (int)temp_cal_c((int32_t)*out);
+    return rc;
+}
+
+#if CFG_TEMP_CAL
+#  define READ_TEMP_RAW(ptr_int) read_temp_calibrated(READ_SENSOR_ARCH, (ptr_int))
+#else
+#  define READ_TEMP_RAW(ptr_int) READ_SENSOR_ARCH(ptr_int)
+#endif
+
+/*
+ * Sensor channel bank (SENSOR_CHANNELS, section 6). For each channel
+ * NAME the table pastes out SENS_CH_NAME (its index), the calibration
+ * constants SENS_GAIN_Q8_NAME and SENS_OFFSET_Q8_NAME, sens_raw_NAME()
+ * (one register read), sens_cal_NAME() and sensor_read_NAME() (degC).
+ * sensor_read_all() is the same code once per channel in a row, with
+ * no channel loop: all raw loads are issued first at constant offsets
+ * from hw_cur, then each value is scaled by its own literal constants.
+ */
+enum {
+#define X(name, desc, gain_q8, offset_q8) SENS_CH_##name,
+    SENSOR_CHANNELS
+#undef X
+    SENSOR_CH_COUNT
+};
+
+#define X(name, desc, gain_q8, offset_q8) \
+    enum { SENS_GAIN_Q8_##name = (gain_q8), SENS_OFFSET_Q8_##name = (offset_q8) }; \
+    static inline uint32_t sens_raw_##name(void) { return REG32(SENS_##name); } \
+    static inline int32_t sens_cal_##name(uint32_t raw) { \
+        int32_t r = raw > TEMP_CAL_RAW_MAX ? TEMP_CAL_RAW_MAX : (int32_t)raw; \
+        return (r * SENS_GAIN_Q8_##name + SENS_OFFSET_Q8_##name + 128) >> 8; \
+    } \
+    static inline int32_t sensor_read_##name(void) { return sens_cal_##name(sens_raw_##name()); }
+SENSOR_CHANNELS
+#undef X
+
+/* One calibrated sample of every channel, degC */
+typedef struct {
+#define X(name, desc, gain_q8, offset_q8) int32_t name;
+    SENSOR_CHANNELS
+#undef X
+} sensor_frame_t;
+
+static inline void sensor_read_all(sensor_frame_t *f) {
+#define X(name, desc, gain_q8, offset_q8) const uint32_t raw_##name = sens_raw_##name();
+    SENSOR_CHANNELS
+#undef X
+#define X(name, desc, gain_q8, offset_q8) f->name = sens_cal_##name(raw_##name);
+    SENSOR_CHANNELS
+#undef X
+}
+
+/*
+ * Waiting for a new sample instead of re-reading SENS_TEMP every pass.
+ * sensor_wait(&seen, timeout_ns) returns 0 (and updates seen) as soon as
+ * the sensor's sample count differs from seen, -1 after timeout_ns
+ * without one. The policy is spin-then-block: the count is polled for
+ * CFG_SENSOR_SPIN_NS, which catches samples that arrive at a high rate
+ * without a syscall, and then the thread sleeps until the interrupt:
+ *   SIM_HW_REGS, Linux:    futex on hw_cur->sens_irq. SIM_SENSOR_SAMPLE()
+ *                          stores SENS_TEMP, bumps the count, and issues
+ *                          FUTEX_WAKE only when someone sleeps
+ *   SIM_HW_REGS, elsewhere: spins until the timeout
+ *   real registers, Linux: poll() on the UIO device CFG_SENSOR_UIO_DEV,
+ *                          whose read() returns the interrupt count (no
+ *                          spin phase: the count only exists in the fd)
+ *   otherwise:             returns 0 at once (plain polling)
+ * READ_TEMP_WAIT(ptr_int, seen, timeout_ns) is READ_TEMP_RAW after a
+ * successful wait; sensor_seen_slot() is the calling thread's seen. The
+ * counters in g_sensor_wait are shared by all waiting threads. Without
+ * CFG_SENSOR_WAIT none of this exists and SIM_SENSOR_SAMPLE() is a
+ * plain store.
+ */
+#if CFG_SENSOR_WAIT
+static struct {
+    _Atomic uint64_t samples;
+    _Atomic uint64_t blocked;      /* waits that went to sleep */
+    _Atomic uint64_t timeouts;
+} g_sensor_wait;
+
+#  if defined(SIM_HW_REGS)
+#    if defined(__linux__)
+#      include <linux/futex.h>
+#      include <sys/syscall.h>
+#      include <unistd.h>
+#    endif
+
+/* The simulated ADC finished a conversion on the bound register file */
+static inline void sensor_irq_raise(void) {
+    atomic_fetch_add_explicit(&hw_cur->sens_irq, 1u, memory_order_seq_cst);
+#    if defined(__linux__)
+    if (UNLIKELY(atomic_load_explicit(&hw_cur->sens_waiters, memory_order_seq_cst) != 0)) {
+        (void)syscall(SYS_futex, &hw_cur->sens_irq, FUTEX_WAKE_PRIVATE, INT32_MAX, NULL, NULL, 0);
+    }
+#    endif
+}
+#    define SIM_SENSOR_SAMPLE(v) SCOPE_DO({ REG32(SENS_TEMP) = (uint32_t)(v); sensor_irq_raise(); })
+
+/* The calling thread's last-seen count; restarts at 0 after hw_bind()
+ * (SIM_FARM.c moves threads between vehicles, often at the same address) */
+static inline uint32_t *sensor_seen_slot(void) {
+    static _Thread_local uint32_t epoch, seen;
+    if (UNLIKELY(epoch != hw_bind_epoch)) { epoch = hw_bind_epoch; seen = 0; }
+    return &seen;
+}
+
+static int sensor_wait(uint32_t *seen, uint64_t timeout_ns) {
+    _Atomic uint32_t *irq = &hw_cur->sens_irq;
+    uint32_t v = atomic_load_explicit(irq, memory_order_acquire);
+    if (LIKELY(v != *seen)) goto got;            /* already there: no clock read */
+    uint64_t start = mono_ns(), spin_end = start + CFG_SENSOR_SPIN_NS, deadline = start + timeout_ns;
+    for (;;) {
+        uint64_t now = mono_ns();
+        if (now >= deadline) break;
+        if (now < spin_end) {
+            CPU_RELAX();
+#    if defined(__linux__)
+        } else {
+            /* Sleeper count first, then re-check: a raise in between
+             * either sees the sleeper or changes the value FUTEX_WAIT
+             * compares against. */
+            atomic_fetch_add_explicit(&hw_cur->sens_waiters, 1u, memory_order_seq_cst);
+            if (atomic_load_explicit(irq, memory_order_seq_cst) == *seen) {
+                uint64_t left = deadline - now;
+                struct timespec ts = { (time_t)(left / 1000000000u), (long)(left % 1000000000u) };
+                atomic_fetch_add_explicit(&g_sensor_wait.blocked, 1u, memory_order_relaxed);
+                (void)syscall(SYS_futex, irq, FUTEX_WAIT_PRIVATE, *seen, &ts, NULL, 0);
+            }
+            atomic_fetch_sub_explicit(&hw_cur->sens_waiters, 1u, memory_order_relaxed);
+#    endif
+        }
+        v = atomic_load_explicit(irq, memory_order_acquire);
+        if (v != *seen) goto got;
+    }
+    atomic_fetch_add_explicit(&g_sensor_wait.timeouts, 1u, memory_order_relaxed);
+    return -1;
+got:
+    *seen = v;
+    atomic_fetch_add_explicit(&g_sensor_wait.samples, 1u, memory_order_relaxed);
+    return 0;
+}
+#  elif defined(__linux__)
+#    include <fcntl.h>
+#    include <poll.h>
+#    include <unistd.h>
+
+static inline uint32_t *sensor_seen_slot(void) {
+    static _Thread_local uint32_t seen;
+    return &seen;
+}
+
+static int sensor_wait(uint32_t *seen, uint64_t timeout_ns) {
+    static int fd = -2;
+    if (UNLIKELY(fd == -2)) fd = open(CFG_SENSOR_UIO_DEV, O_RDWR | O_CLOEXEC);
+    if (fd < 0) return -1;
+    uint32_t on = 1u, count = 0;
+    if (write(fd, &on, sizeof on) != (ssize_t)sizeof on) {
+        /* no irqcontrol in this UIO driver: the interrupt stays enabled */
+    }
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    int rc = poll(&pfd, 1, (int)((timeout_ns + 999999u) / 1000000u));
+    if (rc <= 0 || read(fd, &count, sizeof count) != (ssize_t)sizeof count) {
+        atomic_fetch_add_explicit(&g_sensor_wait.timeouts, 1u, memory_order_relaxed);
+        return -1;
+    }
+    *seen = count;
+    atomic_fetch_add_explicit(&g_sensor_wait.samples, 1u, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_sensor_wait.blocked, 1u, memory_order_relaxed);
+    return 0;
+}
+#  else
+static inline uint32_t *sensor_seen_slot(void) {
+    static _Thread_local uint32_t seen;
+    return &seen;
+}
+
+static int sensor_wait(uint32_t *seen, uint64_t timeout_ns) {
+    (void)seen;
+    (void)timeout_ns;
+    return 0;
+}
+#  endif
+
+#  define READ_TEMP_WAIT(ptr_int, seen, timeout_ns) \
+      (sensor_wait((seen), (timeout_ns)) == 0 ? READ_TEMP_RAW(ptr_int) : -1)
+#endif
+
+#ifndef SIM_SENSOR_SAMPLE
+#  ifdef SIM_HW_REGS
+#    define SIM_SENSOR_SAMPLE(v) ((void)(REG32(SENS_TEMP) = (uint32_t)(v)))  /* no one waits */
+#  else
+#    define SIM_SENSOR_SAMPLE(v) ((void)(v))  /* real sensor: hardware owns SENS_TEMP */
+#  endif
+#endif
+
+#if CFG_SENSOR_WAIT && defined(SIM_HW_REGS)
+/*
+ * Simulated ADC for main() and SENSOR_WAIT_BENCH.c: a thread that raises
+ * the "new sample" interrupt on HW every period_ns (SENS_TEMP keeps what
+ * the demo wrote). last_ns is the time of the latest raise.
+ */
+#  include <pthread.h>
+
+static struct {
+    pthread_t        thread;
+    uint64_t         period_ns;
+    _Atomic int      running;
+    _Atomic uint64_t last_ns;
+    _Atomic uint64_t raised;
+} g_sim_adc;
+
+static void *sim_adc_main(void *arg) {
+    (void)arg;
+    uint64_t next = mono_ns();
+    while (atomic_load_explicit(&g_sim_adc.running, memory_order_relaxed)) {
+        next += g_sim_adc.period_ns;
+        struct timespec ts = { (time_t)(next / 1000000000u), (long)(next % 1000000000u) };
+        (void)clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        atomic_store_explicit(&g_sim_adc.last_ns, mono_ns(), memory_order_relaxed);
+        sensor_irq_raise();
+        atomic_fetch_add_explicit(&g_sim_adc.raised, 1u, memory_order_relaxed);
+    }
+    return NULL;
+}
+
+static int sim_adc_start(uint64_t period_ns) {
+    g_sim_adc.period_ns = period_ns ? period_ns : 1u;
+    atomic_store(&g_sim_adc.running, 1);
+    if (pthread_create(&g_sim_adc.thread, NULL, sim_adc_main, NULL) != 0) {
+        atomic_store(&g_sim_adc.running, 0);
+        return -1;
+    }
+    return 0;
+}
+
+static void sim_adc_stop(void) {
+    if (!atomic_exchange(&g_sim_adc.running, 0)) return;
+    pthread_join(g_sim_adc.thread, NULL);
+}
+#endif
+
+/* ------------------------------------------------------------------
+ * 7b) Sensor acquisition stage (decouples bus stalls from actuation)
+ *     With CFG_SENSOR_ACQ, a dedicated thread samples READ_TEMP_RAW every
+ *     CFG_ACQ_PERIOD_NS (or, with CFG_SENSOR_WAIT, on every new-sample
+ *     interrupt) into a single-producer/single-consumer ring, and
+ *     the control loop takes the newest sample with one acquire load
+ *     instead of touching the sensor bus. Producer and consumer indices
+ *     each own a cache line, and each side caches the other's index so
+ *     the shared lines are only re-read when the ring looks full/empty.
+ *     Build with -pthread.
+ * ------------------------------------------------------------------ */
+#define SPSC_SLOTS     64u  /* power of two */
+
+typedef struct {
+    uint64_t ts_ns;
+    uint32_t seq;
+    int32_t  raw;
+} temp_sample_t;
+
+typedef struct {
+    CACHELINE_ALIGNED _Atomic uint64_t head;  /* written by producer */
+    uint64_t tail_cache;                    /* producer's copy of tail */
+    CACHELINE_ALIGNED _Atomic uint64_t tail;  /* written by consumer */
+    uint64_t head_cache;                    /* consumer's copy of head */
+    CACHELINE_ALIGNED temp_sample_t slot[SPSC_SLOTS];
+} spsc_ring_t;
+
+STATIC_ASSERT((SPSC_SLOTS & (SPSC_SLOTS - 1u)) == 0, spsc_slots_pow2);
+
+/* Producer side: returns -1 (sample dropped) when the ring is full. */
+static inline int spsc_push(spsc_ring_t *r, const temp_sample_t *s) {
+    uint64_t h = atomic_load_explicit(&r->head, memory_order_relaxed);
+    if (UNLIKELY(h - r->tail_cache >= SPSC_SLOTS)) {
+        r->tail_cache = atomic_load_explicit(&r->tail, memory_order_acquire);
+        if (h - r->tail_cache >= SPSC_SLOTS) return -1;
+    }
+    r->slot[h & (SPSC_SLOTS - 1u)] = *s;
+    atomic_store_explicit(&r->head, h + 1u, memory_order_release);
+    return 0;
+}
+
+/* Consumer side, FIFO order: returns -1 when empty. */
+static inline int spsc_pop(spsc_ring_t *r, temp_sample_t *out) {
+    uint64_t t = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    if (t == r->head_cache) {
+        r->head_cache = atomic_load_explicit(&r->head, memory_order_acquire);
+        if (t == r->head_cache) return -1;
+    }
+    *out = r->slot[t & (SPSC_SLOTS - 1u)];
+    atomic_store_explicit(&r->tail, t + 1u, memory_order_release);
+    return 0;
+}
+
+/* Consumer side, newest only: skips (and frees) everything older. */
+static inline int spsc_take_latest(spsc_ring_t *r, temp_sample_t *out) {
+    uint64_t h = atomic_load_explicit(&r->head, memory_order_acquire);
+    if (h == atomic_load_explicit(&r->tail, memory_order_relaxed)) return -1;
+    *out = r->slot[(h - 1u) & (SPSC_SLOTS - 1u)];
+    atomic_store_explicit(&r->tail, h, memory_order_release);
+    return 0;
+}
+
+#if CFG_SENSOR_ACQ
+#  include <pthread.h>
+#  if defined(__linux__)
+#    include <sched.h>
+#  endif
+
+static struct {
+    spsc_ring_t      ring;
+    pthread_t        thread;
+    _Atomic int      running;
+    _Atomic uint64_t samples;
+    _Atomic uint64_t dropped;      /* ring full: consumer fell behind */
+    _Atomic uint64_t read_errors;
+    temp_sample_t    last;         /* consumer-owned */
+    uint32_t         stale_ticks;  /* consumer-owned */
+} g_acq;
+
+static void *acq_thread_main(void *arg) {
+    (void)arg;
+#  if defined(__linux__)
+    if (CFG_ACQ_CPU >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(CFG_ACQ_CPU, &set);
+        (void)pthread_setaffinity_np(pthread_self(), sizeof set, &set);
+    }
+#  endif
+    uint32_t seq  = 0;
+#  if CFG_SENSOR_WAIT
+    uint32_t seen = 0;
+#  else
+    uint64_t next = mono_ns();
+#  endif
+    while (atomic_load_explicit(&g_acq.running, memory_order_relaxed)) {
+        int raw = 0;
+#  if CFG_SENSOR_WAIT
+        /* Paced by the sensor: one sample per interrupt, no timer */
+        if (READ_TEMP_WAIT(&raw, &seen, CFG_SENSOR_WAIT_TIMEOUT_NS) == 0) {
+#  else
+        if (READ_TEMP_RAW(&raw) == 0) {
+#  endif
+            temp_sample_t smp = { mono_ns(), ++seq, (int32_t)raw };
+            if (spsc_push(&g_acq.ring, &smp) != 0) {
+                atomic_fetch_add_explicit(&g_acq.dropped, 1u, memory_order_relaxed);
+            } else {
+                atomic_fetch_add_explicit(&g_acq.samples, 1u, memory_order_relaxed);
+            }
+        } else {
+            atomic_fetch_add_explicit(&g_acq.read_errors, 1u, memory_order_relaxed);
+        }
+#  if !CFG_SENSOR_WAIT
+        next += CFG_ACQ_PERIOD_NS;
+        uint64_t now = mono_ns();
+        if (next <= now) { next = now; continue; }  /* late: resync, no burst */
+        struct timespec ts = { (time_t)(next / 1000000000u), (long)(next % 1000000000u) };
+        (void)clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+#  endif
+    }
+    return NULL;
+}
+
+/* Starts the acquisition thread and waits (<= 100 ms) for its first sample. */
+static int acq_start(void) {
+    atomic_store(&g_acq.running, 1);
+    if (pthread_create(&g_acq.thread, NULL, acq_thread_main, NULL) != 0) return -1;
+    for (uint64_t deadline = mono_ns() + 100000000u; mono_ns() < deadline; ) {
+        if (spsc_take_latest(&g_acq.ring, &g_acq.last) == 0) return 0;
+    }
+    return -1;
+}
+
+static void acq_stop(void) {
+    if (!atomic_exchange(&g_acq.running, 0)) return;
+    pthread_join(g_acq.thread, NULL);
+}
+
+/* Newest raw sample; -1 once no new sample arrived for too many ticks. */
+static inline int acq_read_latest(int *out) {
+    if (spsc_take_latest(&g_acq.ring, &g_acq.last) == 0) g_acq.stale_ticks = 0;
+    else if (UNLIKELY(++g_acq.stale_ticks > CFG_ACQ_MAX_STALE_TICKS)) return -1;
+    *out = g_acq.last.raw;
+    return 0;
+}
+#endif
+
+/* ------------------------------------------------------------------
+ * 7c) Actuator command pipeline (control never waits on a handshake)
+ *     With CFG_ACT_PIPELINE, command_thrust() queues {channel, newtons}
+ *     in a bounded ring and returns; act_pump(), once per tick, moves
+ *     commands through QUEUED -> IN FLIGHT -> ACKED:
+ *       - one STATUS read retires every in-flight command up to the
+ *         echoed ACK_SEQ (actuators complete in order);
+ *       - queued commands are issued while fewer than CFG_ACT_INFLIGHT
+ *         are unacknowledged: THRUST, then the CTRL doorbell (section 6);
+ *       - a command unacknowledged for CFG_ACT_ACK_TIMEOUT_NS is given up
+ *         and act_pump() returns -1.
+ *     A command for a channel that already has one queued replaces it (a
+ *     setpoint: newest wins), so the ring never holds more than
+ *     CFG_ACT_INFLIGHT plus one per channel and cannot overflow. The
+ *     pipeline belongs to the control thread, per thread like the shadow
+ *     registers, and keeps queue-depth and ack-latency statistics.
+ *     Simulated actuators apply a command CFG_SIM_ACT_LATENCY_NS after
+ *     its doorbell.
+ * ------------------------------------------------------------------ */
+#if CFG_ACT_PIPELINE
+#define ACT_RING_SLOTS 128u  /* power of two */
+#define ACT_CH_MAIN    0u    /* command_thrust()'s actuator */
+
+STATIC_ASSERT((ACT_RING_SLOTS & (ACT_RING_SLOTS - 1u)) == 0, act_ring_slots_pow2);
+STATIC_ASSERT(ACT_RING_SLOTS >= CFG_ACT_INFLIGHT + CFG_THRUSTER_CHANNELS, act_ring_never_overflows);
+
+typedef struct {
+    uint64_t t_ns;       /* queued at, then issued at */
+    uint32_t newtons;
+    uint8_t  ch;
+    uint8_t  seq;        /* assigned at issue */
+} act_cmd_t;
+
+static _Thread_local struct {
+    act_cmd_t ring[ACT_RING_SLOTS];
+    uint32_t  head;      /* next free slot */
+    uint32_t  issue;     /* [tail, issue) in flight, [issue, head) queued */
+    uint32_t  tail;      /* oldest in flight */
+    uint8_t   seq;       /* last sequence number issued */
+    uint8_t   acked;     /* last sequence number retired or given up */
+    uint64_t  queued, merged, issued, completed, timeouts;
+    uint64_t  pumps, depth_sum;
+    uint32_t  depth_max;
+    uint64_t  lat_min_ns, lat_max_ns, lat_sum_ns;
+} g_act;
+
+#ifdef SIM_HW_REGS
+/* Simulated actuators: latch the doorbell just written (sequence only) */
+static inline void sim_act_latch(void) {
+    hw_regs_t *r = hw_cur;
+    if (r->sim_act.head - r->sim_act.tail >= SIM_ACT_FIFO) return;  /* lost */
+    uint32_t i = r->sim_act.head++ & (SIM_ACT_FIFO - 1u);
+    r->sim_act.ctrl[i]   = REG32(CTRL);
+    r->sim_act.due_ns[i] = mono_ns() + CFG_SIM_ACT_LATENCY_NS;
+}
+
+/* ...and by the time STATUS is read, acknowledge what is done */
+static inline void sim_act_advance(void) {
+    hw_regs_t *r = hw_cur;
+    uint64_t now = mono_ns();
+    uint32_t status = REG32(STATUS);
+    while (r->sim_act.tail != r->sim_act.head) {
+        uint32_t i = r->sim_act.tail & (SIM_ACT_FIFO - 1u);
+        if (r->sim_act.due_ns[i] > now) break;
+        uint32_t seq = (r->sim_act.ctrl[i] >> CTRL_CMD_SEQ_SHIFT) & 0xFFu;
+        status = (status & ~STATUS_ACK_SEQ_MASK) | seq << STATUS_ACK_SEQ_SHIFT;
+        r->sim_act.tail++;
+    }
+    REG32(STATUS) = status;
+}
+#endif
+
+/* After REG_SYNC: continue the sequence from the doorbell in CTRL */
+static void act_init(void) {
+    memset(&g_act, 0, sizeof g_act);
+    g_act.seq = g_act.acked = (uint8_t)(REG_GET(CTRL) >> CTRL_CMD_SEQ_SHIFT);
+    g_act.lat_min_ns = UINT64_MAX;
+}
+
+static inline void act_submit(uint32_t ch, uint32_t newtons) {
+    ASSERT(ch < CFG_THRUSTER_CHANNELS);
+    ++g_act.queued;
+    for (uint32_t i = g_act.issue; i != g_act.head; ++i) {
+        act_cmd_t *c = &g_act.ring[i & (ACT_RING_SLOTS - 1u)];
+        if (c->ch == ch) { c->newtons = newtons; ++g_act.merged; return; }
+    }
+    g_act.ring[g_act.head++ & (ACT_RING_SLOTS - 1u)] = (act_cmd_t){ mono_ns(), newtons, (uint8_t)ch, 0 };
+}
+
+/* Retire, give up, issue; returns -1 if a command timed out */
+static int act_service(void) {
+    int rc = 0;
+    if (g_act.tail != g_act.issue) {
+#ifdef SIM_HW_REGS
+        sim_act_advance();
+#endif
+        uint8_t base  = g_act.acked;
+        uint8_t ack   = (uint8_t)((REG32(STATUS) & STATUS_ACK_SEQ_MASK) >> STATUS_ACK_SEQ_SHIFT);
+        uint8_t newly = (uint8_t)(ack - base);
+        if (newly > (uint8_t)(g_act.seq - base)) newly = 0;  /* older than base: stale */
+        uint64_t now = mono_ns();
+        while (g_act.tail != g_act.issue) {
+            const act_cmd_t *c = &g_act.ring[g_act.tail & (ACT_RING_SLOTS - 1u)];
+            uint8_t  d   = (uint8_t)(c->seq - base);
+            uint64_t age = now - c->t_ns;
+            if (d != 0 && d <= newly) {
+                ++g_act.completed;
+                g_act.lat_sum_ns += age;
+                if (age < g_act.lat_min_ns) g_act.lat_min_ns = age;
+                if (age > g_act.lat_max_ns) g_act.lat_max_ns = age;
+                g_act.acked = c->seq;
+            } else if (age > CFG_ACT_ACK_TIMEOUT_NS) {
+                LOGF("Actuator ch%u command %u N (seq %u) not acknowledged in %llu us - given up",
+                     (unsigned)c->ch, (unsigned)c->newtons, (unsigned)c->seq,
+                     (unsigned long long)(age / 1000u));
+                ++g_act.timeouts;
+                g_act.acked = c->seq;  /* a late ack for it must not retire newer ones */
+                rc = -1;
+            } else {
+                break;
+            }
+            ++g_act.tail;
+        }
+    }
+    while (g_act.issue != g_act.head && g_act.issue - g_act.tail < CFG_ACT_INFLIGHT) {
+        act_cmd_t *c = &g_act.ring[g_act.issue++ & (ACT_RING_SLOTS - 1u)];
+        c->seq  = ++g_act.seq;
+        c->t_ns = mono_ns();
+        REG_PUT(THRUST, c->newtons);
+        REG_PUT(CTRL, (REG_GET(CTRL) & ~CTRL_CMD_MASK) | (uint32_t)c->seq << CTRL_CMD_SEQ_SHIFT |
+                      (uint32_t)c->ch << CTRL_CMD_CH_SHIFT);
+        REG_FLUSH();  /* one doorbell per command */
+#ifdef SIM_HW_REGS
+        sim_act_latch();
+#endif
+        ++g_act.issued;
+    }
+    return rc;
+}
+
+/* Once per tick; never waits for the actuators */
+static inline int act_pump(void) {
+    int rc = act_service();
+    uint32_t depth = g_act.head - g_act.tail;
+    ++g_act.pumps;
+    g_act.depth_sum += depth;
+    if (depth > g_act.depth_max) g_act.depth_max = depth;
+    return rc;
+}
+
+/* Shutdown: service until nothing is held or timeout_ns passes; -1 if not drained */
+static int act_drain(uint64_t timeout_ns) {
+    int rc = 0;
+    for (uint64_t end = mono_ns() + timeout_ns; g_act.tail != g_act.head; CPU_RELAX()) {
+        if (act_service() != 0 || mono_ns() > end) rc = -1;
+        if (mono_ns() > end) break;
+    }
+    return g_act.tail == g_act.head ? rc : -1;
+}
+
+static void act_log_stats(void) {
+    uint64_t pumps = g_act.pumps ? g_act.pumps : 1u, done = g_act.completed ? g_act.completed : 1u;
+    LOGF("Actuators: %llu queued (%llu merged), %llu issued, %llu acked, %llu timed out",
+         (unsigned long long)g_act.queued, (unsigned long long)g_act.merged,
+         (unsigned long long)g_act.issued, (unsigned long long)g_act.completed,
+         (unsigned long long)g_act.timeouts);
+    LOGF("Actuators: depth max %u avg %llu.%02llu; ack latency min %llu avg %llu max %llu ns",
+         (unsigned)g_act.depth_max, (unsigned long long)(g_act.depth_sum / pumps),
+         (unsigned long long)(g_act.depth_sum * 100u / pumps % 100u),
+         (unsigned long long)(g_act.completed ? g_act.lat_min_ns : 0u),
+         (unsigned long long)(g_act.lat_sum_ns / done), (unsigned long long)g_act.lat_max_ns);
+    (void)pumps;
+    (void)done;
+}
+
+#define QUEUE_THRUST_N(ch, newton) \
+    THRUST_CAPPED_(newton, CFG_MAX_THRUST_N, act_submit((ch), _n), "THRUST queued at %u N")
+#endif
+
+/* ------------------------------------------------------------------
+ * 8) X-macros: error codes and messages kept in sync
+ * ------------------------------------------------------------------ */
+#define ERROR_TABLE \
+    X(ERR_OK,            0,  "No Error") \
+    X(ERR_SENSOR_FAIL,   10, "Sensor Failure") \
+    X(ERR_THRUST_RANGE,  20, "Thrust Out of Range") \
+    X(ERR_SYSTEM_FAULT,  30, "System Fault") \
+    X(ERR_ACT_TIMEOUT,   40, "Actuator Ack Timeout")
+
+typedef enum {
+#define X(name, code, msg) name = code,
+    ERROR_TABLE
+#undef X
+} error_t;
+
+/* Dense index 0..ERR_IDX_COUNT-1 in table order; ERR_IDX_COUNT = unknown */
+enum {
+#define X(name, code, msg) ERR_IDX_##name,
+    ERROR_TABLE
+#undef X
+    ERR_IDX_COUNT
+};
+
+/* Codes span 0..ERR_CODE_SPAN-1: the union is as large as the biggest code */
+typedef union {
+#define X(name, code, msg) char span_##name[(code) + 1];
+    ERROR_TABLE
+#undef X
+} error_code_span_u;
+#define ERR_CODE_SPAN sizeof(error_code_span_u)
+
+STATIC_ASSERT(ERR_IDX_COUNT < 255, error_index_fits_u8);
+STATIC_ASSERT(ERR_CODE_SPAN <= 4096, error_codes_dense_enough_for_tables);
+
+/*
+ * Every name and message lives in one pooled object and the tables hold
+ * 16-bit offsets into it. A table of pointers would need a load-time
+ * relocation per entry in a PIE (it lands in .data.rel.ro and the loader
+ * writes it at every start); offsets keep all of it in .rodata, shared
+ * and untouched until used. Offset 0 is "Unknown", so table gaps need
+ * no test.
+ */
+typedef struct {
+    char msg_unknown[sizeof "Unknown"];
+    char name_unknown[sizeof "ERR_UNKNOWN"];
+#define X(name, code, msg) char name_##name[sizeof #name]; char msg_##name[sizeof msg];
+    ERROR_TABLE
+#undef X
+} error_strings_t;
+
+static const error_strings_t error_strings = {
+    "Unknown", "ERR_UNKNOWN",
+#define X(name, code, msg) #name, msg,
+    ERROR_TABLE
+#undef X
+};
+STATIC_ASSERT(sizeof(error_strings_t) <= UINT16_MAX, error_strings_fit_u16_offsets);
+
+#define ERR_STR_(field) ((uint16_t)offsetof(error_strings_t, field))
+
+static inline const char *error_str_at(uint16_t off) { return (const char *)&error_strings + off; }
+
+/* Code-indexed tables (gaps are 0: "Unknown" / no index), so lookups are one load */
+static const uint16_t error_msg_by_code[ERR_CODE_SPAN] = {
+#define X(name, code, msg) [code] = ERR_STR_(msg_##name),
+    ERROR_TABLE
+#undef X
+};
+static const uint8_t error_idx_by_code[ERR_CODE_SPAN] = {
+#define X(name, code, msg) [code] = ERR_IDX_##name + 1,
+    ERROR_TABLE
+#undef X
+};
+/* Table order, then the unknown-code bucket at ERR_IDX_COUNT */
+static const struct { int32_t code; uint16_t name, msg; } error_info[ERR_IDX_COUNT + 1] = {
+#define X(name, code, msg) { name, ERR_STR_(name_##name), ERR_STR_(msg_##name) },
+    ERROR_TABLE
+#undef X
+    { -1, ERR_STR_(name_unknown), ERR_STR_(msg_unknown) }
+};
+
+static inline const char* error_to_str(error_t e) {
+    return error_str_at((unsigned)e < ERR_CODE_SPAN ? error_msg_by_code[e] : 0u);
+}
+
+static inline unsigned error_index(error_t e) {
+    unsigned i = (unsigned)e < ERR_CODE_SPAN ? error_idx_by_code[e] : 0u;
+    return i ? i - 1u : (unsigned)ERR_IDX_COUNT;
+}
+
+/*
+ * Occurrence counters, one per code plus one for unknown codes. Counting
+ * is a relaxed atomic increment, safe from any thread; error_count()
+ * returns its argument so it can wrap a return value. ERROR_COUNT(rc)
+ * does the same and also keeps the registry ID of the call site that
+ * counted each code last (one relaxed 2-byte store).
+ */
+static _Atomic uint32_t error_counts[ERR_IDX_COUNT + 1];
+static _Atomic uint16_t error_last_site[ERR_IDX_COUNT + 1];
+
+static inline int error_count(int rc) {
+    unsigned i = error_index((error_t)rc);
+    atomic_fetch_add_explicit(&error_counts[i], 1u, memory_order_relaxed);
+    METRICS_ERROR(i);
+    return rc;
+}
+
+#if SITE_REGISTRY
+static inline int error_count_at(int rc, uint16_t site) {
+    unsigned i = error_index((error_t)rc);
+    atomic_fetch_add_explicit(&error_counts[i], 1u, memory_order_relaxed);
+    atomic_store_explicit(&error_last_site[i], site, memory_order_relaxed);
+    METRICS_ERROR(i);
+    return rc;
+}
+
+#  define ERROR_COUNT(rc) \
+      __extension__ ({ \
+          SITE_DEFINE(_err_site, SITE_ERROR, #rc); \
+          error_count_at((rc), site_id(&_err_site)); \
+      })
+#else
+#  define ERROR_COUNT(rc) error_count(rc)
+#endif
+
+typedef struct {
+    int           code;  /* -1 for the "unknown code" bucket */
+    const char   *name;
+    const char   *msg;
+    uint32_t      count;
+    const site_t *last;  /* site of the latest ERROR_COUNT, or NULL */
+} error_stat_t;
+
+/* Copies up to cap counters (table order, then unknown); returns how many. */
+static size_t error_stats_snapshot(error_stat_t *out, size_t cap) {
+    size_t n = 0;
+    for (unsigned i = 0; i <= ERR_IDX_COUNT && n < cap; ++i, ++n) {
+        out[n].code  = (int)error_info[i].code;
+        out[n].name  = error_str_at(error_info[i].name);
+        out[n].msg   = error_str_at(error_info[i].msg);
+        out[n].count = atomic_load_explicit(&error_counts[i], memory_order_relaxed);
+#if SITE_REGISTRY
+        out[n].last  = site_at(atomic_load_explicit(&error_last_site[i], memory_order_relaxed));
+#else
+        out[n].last  = NULL;
+#endif
+    }
+    return n;
+}
+
+#if CFG_METRICS_SHM && (defined(__GNUC__) || defined(__clang__))
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+
+STATIC_ASSERT(ERR_IDX_COUNT + 1 <= METRICS_ERR_SLOTS, metrics_block_has_every_error_slot);
+
+/*
+ * Creates or takes over the metrics block (section 4b) and moves the
+ * counts made so far into it. On failure the private block stays in use.
+ */
+static int metrics_open(void) {
+    int fd = shm_open(CFG_METRICS_SHM_NAME, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return -1;
+    if (ftruncate(fd, (off_t)sizeof(metrics_block_t)) != 0) { close(fd); return -1; }
+    void *p = mmap(NULL, sizeof(metrics_block_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return -1;
+    metrics_block_t *m = p;
+    m->magic = 0;
+    atomic_thread_fence(memory_order_release);
+    memcpy(m, &g_metrics_local, sizeof *m);
+    m->version   = METRICS_VERSION;
+    m->size      = (uint32_t)sizeof *m;
+    m->err_slots = ERR_IDX_COUNT + 1u;
+    m->pid       = (uint64_t)getpid();
+    m->t0_ns     = mono_ns();
+    m->t0_ticks  = cycles_now();
+    for (unsigned i = 0; i <= ERR_IDX_COUNT; ++i) {
+        snprintf(m->err_name[i], METRICS_NAME_LEN, "%s", error_str_at(error_info[i].name));
+    }
+    atomic_store_explicit(&m->clock_ns, m->t0_ns, memory_order_relaxed);
+    atomic_store_explicit(&m->clock_ticks, m->t0_ticks, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    m->magic = METRICS_MAGIC;
+    g_metrics = m;
+    return 0;
+}
+#endif
+
+/* ------------------------------------------------------------------
+ * 8b) Start-up timing and warm restart (CFG_WARM_START)
+ *     boot_ns is stamped by a constructor, before main() and before any
+ *     other start-up code of ours; main() reports how long it took from
+ *     there to the first control tick that returned ERR_OK. The loader's
+ *     share (exec to constructor) is COLD_START_BENCH.c's to measure.
+ *
+ *     The warm file holds the state of the last valid tick: the values
+ *     of the software-owned registers (SHADOW_REG_TABLE), the shadow's
+ *     write statistics and the error counters. init_system() maps it
+ *     MAP_SHARED and prefaulted, so a save is a few plain stores into
+ *     the page cache: no syscall on the loop, and a crash loses nothing
+ *     the last WARM_SAVE() stored. Two slots alternate under a sequence
+ *     number that is published last; a save cut short by a crash leaves
+ *     the previous slot current. The file survives power loss only once
+ *     the kernel has written it back (no msync on the loop).
+ *
+ *     Simulated registers come back up zeroed, so a warm start writes
+ *     the saved registers back before REG_SYNC() adopts them. Real
+ *     registers keep their values across a process restart and are
+ *     adopted as they are: restoring a stale command would be unsafe.
+ *     One control thread saves; SIM_FARM.c refuses CFG_WARM_START.
+ * ------------------------------------------------------------------ */
+static uint64_t boot_ns;
+static uint64_t boot_first_tick_ns;
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((constructor(101))) static void boot_mark(void) { boot_ns = mono_ns(); }
+#endif
+
+/* First valid tick: call with each tick's rc; returns start-to-tick ns once, else 0 */
+static inline uint64_t boot_note_tick(int rc) {
+    if (LIKELY(boot_first_tick_ns != 0) || rc != ERR_OK) return 0;
+    boot_first_tick_ns = mono_ns();
+    return boot_ns ? boot_first_tick_ns - boot_ns : 0; /* 0: no constructor stamp */
+}
+
+#if CFG_WARM_START
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+
+#  define WARM_MAGIC    0x4D52414Eu  /* "NARM" */
+#  define WARM_VERSION  1u
+
+typedef struct {
+    uint64_t ticks;                          /* valid ticks saved, over all runs */
+    struct {
+#define X(name) uint32_t name;
+        SHADOW_REG_TABLE
+#undef X
+    } reg;
+    uint32_t errors[ERR_IDX_COUNT + 1];
+#  if CFG_SHADOW_REGS
+    uint64_t puts, skipped, coalesced, bus_writes;
+#  endif
+} warm_state_t;
+
+typedef struct {
+    uint32_t magic;                          /* written last: the header is complete */
+    uint32_t version;
+    uint32_t size;                           /* sizeof(warm_file_t): the layout matches */
+    uint32_t restores;                       /* warm starts from this file */
+    _Atomic uint32_t seq;                    /* slot[seq & 1] is the last complete save */
+    CACHELINE_ALIGNED warm_state_t slot[2];
+} warm_file_t;
+
+static warm_file_t  g_warm_local;            /* saves land here when there is no file */
+static warm_file_t *g_warm = &g_warm_local;
+
+static inline void warm_save(void) {
+    uint32_t seq = atomic_load_explicit(&g_warm->seq, memory_order_relaxed);
+    const warm_state_t *cur = &g_warm->slot[seq & 1u];
+    warm_state_t *w = &g_warm->slot[(seq + 1u) & 1u];
+    w->ticks = cur->ticks + 1u;
+#define X(name) w->reg.name = REG_GET(name);
+    SHADOW_REG_TABLE
+#undef X
+    for (unsigned i = 0; i <= ERR_IDX_COUNT; ++i) {
+        w->errors[i] = atomic_load_explicit(&error_counts[i], memory_order_relaxed);
+    }
+#  if CFG_SHADOW_REGS
+    w->puts = g_shadow.puts;
+    w->skipped = g_shadow.skipped;
+    w->coalesced = g_shadow.coalesced;
+    w->bus_writes = g_shadow.bus_writes;
+#  endif
+    atomic_store_explicit(&g_warm->seq, seq + 1u, memory_order_release);
+}
+
+/*
+ * Maps CFG_WARM_STATE_PATH; before REG_SYNC(). Returns 1 after a warm
+ * start, 0 after a cold one (no file or another layout: it is reset),
+ * -1 if the file is unusable (saves then stay in memory).
+ */
+static int warm_open(void) {
+    int fd = open(CFG_WARM_STATE_PATH, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return -1;
+    struct stat st;
+    int fits = fstat(fd, &st) == 0 && st.st_size == (off_t)sizeof(warm_file_t);
+    if (!fits && ftruncate(fd, (off_t)sizeof(warm_file_t)) != 0) { close(fd); return -1; }
+    void *p = mmap(NULL, sizeof(warm_file_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return -1;
+    warm_file_t *f = p;
+    g_warm = f;
+    if (!fits || f->magic != WARM_MAGIC || f->version != WARM_VERSION || f->size != sizeof *f) {
+        memset(f, 0, sizeof *f);
+        f->version = WARM_VERSION;
+        f->size    = (uint32_t)sizeof *f;
+        atomic_thread_fence(memory_order_release);
+        f->magic   = WARM_MAGIC;
+        return 0;
+    }
+    const warm_state_t *w = &f->slot[atomic_load_explicit(&f->seq, memory_order_acquire) & 1u];
+    if (w->ticks == 0) return 0;
+    f->restores++;
+#  ifdef SIM_HW_REGS
+#define X(name) REG32(name) = w->reg.name;
+    SHADOW_REG_TABLE
+#undef X
+#  endif
+    for (unsigned i = 0; i <= ERR_IDX_COUNT; ++i) {
+        atomic_store_explicit(&error_counts[i], w->errors[i], memory_order_relaxed);
+    }
+#  if CFG_SHADOW_REGS
+    g_shadow.puts = w->puts;
+    g_shadow.skipped = w->skipped;
+    g_shadow.coalesced = w->coalesced;
+    g_shadow.bus_writes = w->bus_writes;
+#  endif
+    return 1;
+}
+
+#  define WARM_SAVE() warm_save()
+#else
+#  define WARM_SAVE() ((void)0)
+#endif
+
+/* ------------------------------------------------------------------
+ * 9) Tiny guidance/control demo using the macros above
+ * ------------------------------------------------------------------ */
+/* Demo policy: temperature -> thrust (shared with the batched engine) */
+#define POLICY_TEMP_SPLIT_C  30
+#define POLICY_COLD_N        3000u
+#define POLICY_HOT_N         1500u
+
+static NOINLINE int init_system(void) {
+    TRACE();
+    PROFILE_SCOPE(init_system);
+#ifndef SIM_HW_REGS
+    if (hw_map() != 0) return ERR_SYSTEM_FAULT;
+#endif
+#if CFG_WARM_START
+    int warm = warm_open();
+    LOGF("Start: %s (%s)", warm > 0 ? "warm" : warm == 0 ? "cold" : "cold, no warm file",
+         CFG_WARM_STATE_PATH);
+    (void)warm;
+#endif
+    REG_SYNC();
+    ENABLE_SYSTEM();
+    REG_FLUSH();
+#if CFG_ACT_PIPELINE
+    act_init();
+#endif
+    SIM_SENSOR_SAMPLE(42); /* seed */
+#if CFG_SENSOR_ACQ
+    if (acq_start() != 0) return ERR_SENSOR_FAIL;
+#endif
+    return 0; /* simulate success */
+}
+
+static NOINLINE int poll_temperature_c(int *out_c) {
+    TRACE();
+    PROFILE_SCOPE(poll_temperature_c);
+    int raw = 0;
+#if CFG_SENSOR_ACQ
+    if (acq_read_latest(&raw) != 0) return ERR_SENSOR_FAIL;
+#elif CFG_SENSOR_WAIT
+    if (READ_TEMP_WAIT(&raw, sensor_seen_slot(), CFG_SENSOR_WAIT_TIMEOUT_NS) != 0) return ERR_SENSOR_FAIL;
+#else
+    if (READ_TEMP_RAW(&raw) != 0) return ERR_SENSOR_FAIL;
+#endif
+    /* Linearization happens behind READ_TEMP_RAW (CFG_TEMP_CAL, section 7) */
+    *out_c = raw; /* degC: calibrated, or the demo sensor already is */
+    LOGF("Temp=%d C", *out_c);
+    return ERR_OK;
+}
+
+static NOINLINE int command_thrust(uint32_t desired_n) {
+    TRACE();
+    PROFILE_SCOPE(command_thrust);
+    if (desired_n > (CFG_MAX_THRUST_N * 2)) {
+        return ERR_THRUST_RANGE; /* clearly insane input */
+    }
+#if CFG_ACT_PIPELINE
+    QUEUE_THRUST_N(ACT_CH_MAIN, desired_n); /* issued by act_pump() */
+#else
+    SET_THRUST_N(desired_n);
+#endif
+    return ERR_OK;
+}
+
+static NOINLINE int run_control_loop_once(void) {
+    METRICS_LOOP_SCOPE();
+    TRACE();
+    PROFILE_SCOPE(run_control_loop_once);
+    int temp_c = 0;
+    int rc = poll_temperature_c(&temp_c);
+    if (rc != ERR_OK) return ERROR_COUNT(rc);
+
+    /* Simple policy: map temperature to thrust */
+    uint32_t desired = (temp_c < POLICY_TEMP_SPLIT_C) ? POLICY_COLD_N : POLICY_HOT_N;
+    rc = command_thrust(desired);
+    if (rc != ERR_OK) return ERROR_COUNT(rc);
+#if CFG_ACT_PIPELINE
+    if (act_pump() != 0) return ERROR_COUNT(ERR_ACT_TIMEOUT);
+#endif
+    REG_FLUSH(); /* end of tick: one ordered burst of changed registers */
+    hw_snapshot_t regs;
+    hw_burst_read(&regs); /* one read of the window: publish and fault check */
+    hw_snapshot_publish(&regs);
+
+    if (UNLIKELY(regs.CTRL & CTRL_FAULT)) {
+        return ERROR_COUNT(ERR_SYSTEM_FAULT);
+    }
+    WARM_SAVE();
+    return ERR_OK;
+}
+
+/* ------------------------------------------------------------------
+ * 10) Batched multi-thruster engine (structure-of-arrays, SIMD policy)
+ *     Temperatures and thrust commands live in separate aligned arrays so
+ *     the policy map and CFG_MAX_THRUST_N clamp run branch-free over many
+ *     channels per instruction. The vector ISA follows the *compiler's*
+ *     target (__AVX2__/__SSE2__/__ARM_NEON/__riscv_vector), since CPU_ARM
+ *     and CPU_RISCV only name the flight CPU; other targets use the
+ *     scalar branch-free loop. Capped channels come back as a bitmask and
+ *     are logged per channel off the hot path.
+ * ------------------------------------------------------------------ */
+typedef struct {
+    CACHELINE_ALIGNED int32_t  temp_c[CFG_THRUSTER_CHANNELS];   /* inputs, degC */
+    CACHELINE_ALIGNED uint32_t thrust_n[CFG_THRUSTER_CHANNELS]; /* outputs, N   */
+} thruster_bank_t;
+
+static inline uint32_t policy_thrust_scalar(int32_t t, uint32_t limit, uint64_t *over) {
+    uint32_t d = POLICY_HOT_N + (uint32_t)(t < POLICY_TEMP_SPLIT_C) * (POLICY_COLD_N - POLICY_HOT_N);
+    *over = d > limit;
+    return *over ? limit : d;
+}
+
+/* Maps temp_c[0..n) to thrust_n[0..n) capped at limit; returns the capped-
+ * channel mask. Always inlined so constant n/limit (section 10b) fold. */
+static ALWAYS_INLINE uint64_t thrust_policy_kernel(const int32_t *temp, uint32_t *thrust,
+                                                   unsigned n, uint32_t limit) {
+    uint64_t mask = 0;
+    unsigned i = 0;
+#if defined(__AVX2__)
+    const __m256i split = _mm256_set1_epi32(POLICY_TEMP_SPLIT_C);
+    const __m256i cold  = _mm256_set1_epi32((int)POLICY_COLD_N);
+    const __m256i hot   = _mm256_set1_epi32((int)POLICY_HOT_N);
+    const __m256i cap   = _mm256_set1_epi32((int)limit);
+    for (; i + 8u <= n; i += 8u) {
+        __m256i t    = _mm256_loadu_si256((const __m256i *)(temp + i));
+        __m256i d    = _mm256_blendv_epi8(hot, cold, _mm256_cmpgt_epi32(split, t));
+        __m256i over = _mm256_cmpgt_epi32(d, cap);
+        _mm256_storeu_si256((__m256i *)(thrust + i), _mm256_min_epu32(d, cap));
+        mask |= (uint64_t)(unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(over)) << i;
+    }
+#elif defined(__SSE2__)
+    const __m128i split = _mm_set1_epi32(POLICY_TEMP_SPLIT_C);
+    const __m128i cold  = _mm_set1_epi32((int)POLICY_COLD_N);
+    const __m128i hot   = _mm_set1_epi32((int)POLICY_HOT_N);
+    const __m128i cap   = _mm_set1_epi32((int)limit);
+    for (; i + 4u <= n; i += 4u) {
+        __m128i t    = _mm_loadu_si128((const __m128i *)(temp + i));
+        __m128i lt   = _mm_cmpgt_epi32(split, t);
+        __m128i d    = _mm_or_si128(_mm_and_si128(lt, cold), _mm_andnot_si128(lt, hot));
+        __m128i over = _mm_cmpgt_epi32(d, cap);
+        __m128i out  = _mm_or_si128(_mm_and_si128(over, cap), _mm_andnot_si128(over, d));
+        _mm_storeu_si128((__m128i *)(thrust + i), out);
+        mask |= (uint64_t)(unsigned)_mm_movemask_ps(_mm_castsi128_ps(over)) << i;
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    static const uint32_t lane_bit[4] = { 1u, 2u, 4u, 8u };
+    const uint32x4_t bits  = vld1q_u32(lane_bit);
+    const int32x4_t  split = vdupq_n_s32(POLICY_TEMP_SPLIT_C);
+    const uint32x4_t cold  = vdupq_n_u32(POLICY_COLD_N);
+    const uint32x4_t hot   = vdupq_n_u32(POLICY_HOT_N);
+    const uint32x4_t cap   = vdupq_n_u32(limit);
+    for (; i + 4u <= n; i += 4u) {
+        uint32x4_t d    = vbslq_u32(vcltq_s32(vld1q_s32(temp + i), split), cold, hot);
+        uint32x4_t over = vcgtq_u32(d, cap);
+        vst1q_u32(thrust + i, vminq_u32(d, cap));
+        mask |= (uint64_t)vaddvq_u32(vandq_u32(over, bits)) << i;
+    }
+#elif defined(__riscv_vector)
+    for (size_t vl; i < n; i += (unsigned)vl) {
+        vl = __riscv_vsetvl_e32m1(n - i);
+        vint32m1_t  t    = __riscv_vle32_v_i32m1(temp + i, vl);
+        vbool32_t   lt   = __riscv_vmslt_vx_i32m1_b32(t, POLICY_TEMP_SPLIT_C, vl);
+        vuint32m1_t d    = __riscv_vmerge_vxm_u32m1(__riscv_vmv_v_x_u32m1(POLICY_HOT_N, vl),
+                                                    POLICY_COLD_N, lt, vl);
+        vbool32_t   over = __riscv_vmsgtu_vx_u32m1_b32(d, limit, vl);
+        __riscv_vse32_v_u32m1(thrust + i, __riscv_vminu_vx_u32m1(d, limit, vl), vl);
+        uint32_t lanes[64];
+        __riscv_vse32_v_u32m1(lanes, __riscv_vmerge_vxm_u32m1(__riscv_vmv_v_x_u32m1(0, vl),
+                                                              1u, over, vl), vl);
+        for (size_t k = 0; k < vl; ++k) mask |= (uint64_t)lanes[k] << (i + k);
+    }
+#endif
+    for (; i < n; ++i) {  /* scalar tail (or whole batch without SIMD) */
+        uint64_t over;
+        thrust[i] = policy_thrust_scalar(temp[i], limit, &over);
+        mask |= over << i;
+    }
+    return mask;
+}
+
+/* One batched tick: policy + clamp for every channel; returns capped mask. */
+static uint64_t run_thruster_bank_once(thruster_bank_t *b) {
+    TRACE();
+    uint64_t mask = thrust_policy_kernel(b->temp_c, b->thrust_n, CFG_THRUSTER_CHANNELS, CFG_MAX_THRUST_N);
+    LOGF_EVERY_MS(mask != 0, LOG_CAP_INTERVAL_MS,
+                  "Bank: %u channel(s) capped at %u N (mask 0x%llx)",
+                  (unsigned)__builtin_popcountll(mask), (unsigned)CFG_MAX_THRUST_N,
+                  (unsigned long long)mask);
+    return mask;
+}
+
+/* ------------------------------------------------------------------
+ * 10b) Build profiles: one specialized control loop per table row
+ *      A ground-test binary links several vehicle profiles side by side.
+ *      Each CONTROL_PROFILE_TABLE row stamps out run_control_loop_once_<name>()
+ *      and run_thruster_bank_once_<name>() from always-inlined bodies in
+ *      which the thrust limit and channel count are literals: the
+ *      command_thrust() range check and the SET_THRUST_N cap fold against
+ *      the two policy outputs (a row that can never cap keeps neither), and
+ *      the bank kernel runs a fixed trip count. control_profiles[] lists
+ *      every copy after the instrumented "generic" loop; the caller picks
+ *      one and pays a single indirect call per tick. Logs, asserts and the
+ *      CPU stay per-build choices.
+ * ------------------------------------------------------------------ */
+/* A row's channel count, limited to the bank this build has */
+#define PROFILE_CHANNELS_(n) ((n) < CFG_THRUSTER_CHANNELS ? (n) : CFG_THRUSTER_CHANNELS)
+
+#define CONTROL_PROFILE_TABLE \
+    X(build,    CFG_MAX_THRUST_N, CFG_THRUSTER_CHANNELS) /* this build's limits */ \
+    X(flight,   5000,             PROFILE_CHANNELS_(16)) \
+    X(ground,   4000,             PROFILE_CHANNELS_(16)) \
+    X(derated,  2000,             PROFILE_CHANNELS_(8)) /* caps the cold policy */ \
+    X(single,   6000,             1)
+
+#define X(name, max_n, channels) \
+    STATIC_ASSERT((max_n) > 0 && (max_n) <= 6000, profile_##name##_thrust_within_structural_limit); \
+    STATIC_ASSERT((channels) >= 1 && (channels) <= CFG_THRUSTER_CHANNELS, profile_##name##_fits_bank);
+CONTROL_PROFILE_TABLE
+#undef X
+
+/* run_control_loop_once() with command_thrust() inlined against `limit` */
+static ALWAYS_INLINE int control_loop_profile_(uint32_t limit) {
+    int temp_c = 0;
+    int rc = poll_temperature_c(&temp_c);
+    if (rc != ERR_OK) return ERROR_COUNT(rc);
+
+    uint32_t desired = (temp_c < POLICY_TEMP_SPLIT_C) ? POLICY_COLD_N : POLICY_HOT_N;
+    if (desired > limit * 2u) return ERROR_COUNT(ERR_THRUST_RANGE);
+#if CFG_ACT_PIPELINE
+    THRUST_CAPPED_(desired, limit, act_submit(ACT_CH_MAIN, _n), "THRUST queued at %u N");
+    if (act_pump() != 0) return ERROR_COUNT(ERR_ACT_TIMEOUT);
+#else
+    THRUST_CAPPED_(desired, limit, REG_PUT(THRUST, _n), "THRUST set to %u N");
+#endif
+    REG_FLUSH();
+    hw_snapshot_t regs;
+    hw_burst_read(&regs);
+    hw_snapshot_publish(&regs);
+
+    if (UNLIKELY(regs.CTRL & CTRL_FAULT)) {
+        return ERROR_COUNT(ERR_SYSTEM_FAULT);
+    }
+    WARM_SAVE();
+    return ERR_OK;
+}
+
+/* run_thruster_bank_once() over the first n channels, capped at `limit` */
+static ALWAYS_INLINE uint64_t thruster_bank_profile_(thruster_bank_t *b, unsigned n, uint32_t limit) {
+    uint64_t mask = thrust_policy_kernel(b->temp_c, b->thrust_n, n, limit);
+    LOGF_EVERY_MS(mask != 0, LOG_CAP_INTERVAL_MS,
+                  "Bank: %u channel(s) capped at %u N (mask 0x%llx)",
+                  (unsigned)__builtin_popcountll(mask), (unsigned)limit, (unsigned long long)mask);
+    return mask;
+}
+
+#define X(name, max_n, channels) \
+    static int run_control_loop_once_##name(void) { \
+        METRICS_LOOP_SCOPE(); \
+        TRACE(); \
+        PROFILE_SCOPE(run_control_loop_once_##name); \
+        return control_loop_profile_(max_n); \
+    } \
+    static uint64_t run_thruster_bank_once_##name(thruster_bank_t *b) { \
+        TRACE(); \
+        return thruster_bank_profile_(b, channels, max_n); \
+    }
+CONTROL_PROFILE_TABLE
+#undef X
+
+typedef struct {
+    const char *name;
+    uint32_t    max_thrust_n;
+    uint32_t    channels;                      /* bank channels bank_once() drives */
+    int       (*control_once)(void);
+    uint64_t  (*bank_once)(thruster_bank_t *b);
+} control_profile_t;
+
+static const control_profile_t control_profiles[] = {
+    { "generic", CFG_MAX_THRUST_N, CFG_THRUSTER_CHANNELS, run_control_loop_once, run_thruster_bank_once },
+#define X(name, max_n, channels) \
+    { #name, (max_n), (channels), run_control_loop_once_##name, run_thruster_bank_once_##name },
+    CONTROL_PROFILE_TABLE
+#undef X
+};
+#define CONTROL_PROFILE_COUNT (sizeof control_profiles / sizeof control_profiles[0])
+
+/* Profile that main() and the scheduler's control task tick */
+static const control_profile_t *g_ctl_profile = &control_profiles[0];
+
+static const control_profile_t *control_profile_find(const char *name) {
+    for (size_t i = 0; i < CONTROL_PROFILE_COUNT; ++i) {
+        if (strcmp(control_profiles[i].name, name) == 0) return &control_profiles[i];
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------
+ * 11) Telemetry frames (delta-encoded, bit-packed register snapshots)
+ *     One sample per tick holds every HW_REG_TABLE register. Frames are
+ *     fixed-size and self-contained: the first sample of each frame is
+ *     sent raw, so a lost frame only loses its own ticks.
+ *
+ *     Frame: 12-byte little-endian header, then an LSB-first bit stream
+ *       u16 magic "TF" | u16 seq | u32 first_tick | u16 nsamples | u16 nbits
+ *       per sample, per register in table order:
+ *         0                        unchanged since the previous sample
+ *         1 0 + zigzag(delta)      fits in the register's tlm_delta_bits
+ *         1 1 + u32 value          raw (always for a frame's first sample)
+ *     Bytes past nbits are zero. A steady register costs one bit a tick.
+ * ------------------------------------------------------------------ */
+#define TLM_FRAME_BYTES   1024u      /* BUFFER_SIZE, as in OBJECT_TYPE_MACRO.c */
+#define TLM_HDR_BYTES     12u
+#define TLM_MAGIC         0x4654u    /* "TF" */
+#define TLM_PAYLOAD_BITS  ((TLM_FRAME_BYTES - TLM_HDR_BYTES) * 8u)
+
+typedef hw_snapshot_t tlm_sample_t;
+
+enum {
+    TLM_REGS = 0
+#define X(name, desc, dbits) + 1
+    HW_REG_TABLE
+#undef X
+    ,
+    TLM_SAMPLE_MAX_BITS = TLM_REGS * (2 + 32),   /* every register raw */
+    TLM_MAX_SAMPLES     = TLM_PAYLOAD_BITS / TLM_REGS /* every register unchanged */
+};
+
+#define X(name, desc, dbits) \
+    STATIC_ASSERT((dbits) >= 1 && (dbits) <= 30, tlm_delta_bits_##name);
+HW_REG_TABLE
+#undef X
+STATIC_ASSERT(TLM_PAYLOAD_BITS <= 0xFFFFu, tlm_nbits_fits_u16);
+
+typedef void (*tlm_emit_fn)(const uint8_t *frame, size_t len, void *ctx);
+
+typedef struct {
+    uint8_t      frame[TLM_FRAME_BYTES];
+    uint64_t     acc;          /* bits not yet stored, LSB first */
+    unsigned     acc_bits;
+    uint32_t     pos;          /* next frame byte */
+    uint32_t     nbits;        /* payload bits in the open frame */
+    uint16_t     nsamples;     /* samples in the open frame */
+    uint16_t     seq;
+    uint32_t     tick;         /* tick index of the next sample */
+    tlm_sample_t prev;
+    tlm_emit_fn  emit;
+    void        *ctx;
+    uint64_t     samples;
+    uint64_t     frames;
+    uint64_t     payload_bits; /* over all emitted frames */
+} tlm_encoder_t;
+
+static inline void tlm_le16(uint8_t *p, uint32_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static inline void tlm_le32(uint8_t *p, uint32_t v) { tlm_le16(p, v); tlm_le16(p + 2, v >> 16); }
+static inline uint32_t tlm_rd16(const uint8_t *p) { return (uint32_t)p[0] | (uint32_t)p[1] << 8; }
+static inline uint32_t tlm_rd32(const uint8_t *p) { return tlm_rd16(p) | tlm_rd16(p + 2) << 16; }
+
+static inline uint32_t tlm_zigzag(uint32_t d)   { return (d << 1) ^ (0u - (d >> 31)); }
+static inline uint32_t tlm_unzigzag(uint32_t z) { return (z >> 1) ^ (0u - (z & 1u)); }
+
+static void tlm_init(tlm_encoder_t *e, tlm_emit_fn emit, void *ctx) {
+    memset(e, 0, sizeof *e);
+    e->pos  = TLM_HDR_BYTES;
+    e->emit = emit;
+    e->ctx  = ctx;
+}
+
+/* Append n <= 32 bits (v must fit); whole bytes go out as they fill */
+static inline void tlm_put_bits(tlm_encoder_t *e, uint32_t v, unsigned n) {
+    e->acc |= (uint64_t)v << e->acc_bits;
+    e->acc_bits += n;
+    e->nbits += n;
+    while (e->acc_bits >= 8u) {
+        e->frame[e->pos++] = (uint8_t)e->acc;
+        e->acc >>= 8;
+        e->acc_bits -= 8u;
+    }
+}
+
+static inline void tlm_put_field(tlm_encoder_t *e, uint32_t cur, uint32_t prev,
+                                 unsigned dbits, int key) {
+    if (LIKELY(!key)) {
+        if (cur == prev) { tlm_put_bits(e, 0u, 1); return; }
+        uint32_t z = tlm_zigzag(cur - prev);
+        if (z < (1u << dbits)) { tlm_put_bits(e, 1u | z << 2, 2u + dbits); return; }
+    }
+    tlm_put_bits(e, 3u, 2);
+    tlm_put_bits(e, cur, 32);
+}
+
+/* Close the open frame (if any), zero its tail and hand it to emit(). */
+static void tlm_flush(tlm_encoder_t *e) {
+    if (e->nsamples == 0) return;
+    if (e->acc_bits) e->frame[e->pos++] = (uint8_t)e->acc;
+    memset(e->frame + e->pos, 0, TLM_FRAME_BYTES - e->pos);
+    tlm_le16(e->frame + 0, TLM_MAGIC);
+    tlm_le16(e->frame + 2, e->seq);
+    tlm_le32(e->frame + 4, e->tick - e->nsamples);
+    tlm_le16(e->frame + 8, e->nsamples);
+    tlm_le16(e->frame + 10, e->nbits);
+    e->emit(e->frame, TLM_FRAME_BYTES, e->ctx);
+    e->frames++;
+    e->payload_bits += e->nbits;
+    e->seq++;
+    e->acc = 0;
+    e->acc_bits = 0;
+    e->pos = TLM_HDR_BYTES;
+    e->nbits = 0;
+    e->nsamples = 0;
+}
+
+static void tlm_push(tlm_encoder_t *e, const tlm_sample_t *s) {
+    if (UNLIKELY(e->nbits + TLM_SAMPLE_MAX_BITS > TLM_PAYLOAD_BITS)) tlm_flush(e);
+    const int key = e->nsamples == 0;
+#define X(name, desc, dbits) tlm_put_field(e, s->name, e->prev.name, (dbits), key);
+    HW_REG_TABLE
+#undef X
+    e->prev = *s;
+    e->nsamples++;
+    e->tick++;
+    e->samples++;
+}
+
+/* Snapshot the register file and append it: call once per tick */
+static inline void tlm_tick(tlm_encoder_t *e) {
+    tlm_sample_t s;
+    hw_burst_read(&s);
+    tlm_push(e, &s);
+}
+
+typedef struct {
+    const uint8_t *p;          /* payload */
+    uint32_t       pos;        /* next bit */
+    uint32_t       nbits;
+} tlm_reader_t;
+
+static inline int tlm_get_bits(tlm_reader_t *r, unsigned n, uint32_t *v) {
+    if (r->pos + n > r->nbits) return -1;
+    uint32_t byte = r->pos >> 3, lim = (r->nbits + 7u) >> 3;
+    uint64_t w = 0;
+    for (unsigned i = 0; i < 5u && byte + i < lim; ++i) w |= (uint64_t)r->p[byte + i] << (8u * i);
+    *v = (uint32_t)((w >> (r->pos & 7u)) & ((1ull << n) - 1u));
+    r->pos += n;
+    return 0;
+}
+
+static inline int tlm_get_field(tlm_reader_t *r, uint32_t *val, unsigned dbits, int key) {
+    uint32_t b, z;
+    if (tlm_get_bits(r, 1, &b) != 0) return -1;
+    if (!b) return key ? -1 : 0;
+    if (tlm_get_bits(r, 1, &b) != 0) return -1;
+    if (b) return tlm_get_bits(r, 32, val);
+    if (key || tlm_get_bits(r, dbits, &z) != 0) return -1;
+    *val += tlm_unzigzag(z);
+    return 0;
+}
+
+/*
+ * Decode one frame into out[0..cap). Returns the sample count, or -1 for
+ * a frame that is short, foreign, larger than cap or inconsistent.
+ */
+static int tlm_decode_frame(const uint8_t *f, size_t len, uint32_t *first_tick,
+                            tlm_sample_t *out, size_t cap) {
+    if (len < TLM_FRAME_BYTES || tlm_rd16(f) != TLM_MAGIC) return -1;
+    uint32_t n = tlm_rd16(f + 8);
+    tlm_reader_t r = { f + TLM_HDR_BYTES, 0, tlm_rd16(f + 10) };
+    if (r.nbits > TLM_PAYLOAD_BITS || n > cap) return -1;
+    if (first_tick) *first_tick = tlm_rd32(f + 4);
+    tlm_sample_t cur = {0};
+    for (uint32_t i = 0; i < n; ++i) {
+#define X(name, desc, dbits) if (tlm_get_field(&r, &cur.name, (dbits), i == 0) != 0) return -1;
+        HW_REG_TABLE
+#undef X
+        out[i] = cur;
+    }
+    return r.pos == r.nbits ? (int)n : -1;
+}
+
+/*
+ * Demo downlink used by main(): round-trips every frame through the
+ * decoder (the last sample must match what was pushed) and, with
+ * CFG_TLM_DOWNLINK, appends the frame to CFG_TLM_PATH.
+ */
+typedef struct {
+    tlm_encoder_t enc;
+    FILE         *out;
+    uint64_t      decoded;
+    uint64_t      bad_frames;
+} tlm_link_t;
+
+static void tlm_link_emit(const uint8_t *frame, size_t len, void *ctx) {
+    static tlm_sample_t dec[TLM_MAX_SAMPLES];
+    tlm_link_t *l = ctx;
+    int n = tlm_decode_frame(frame, len, NULL, dec, TLM_MAX_SAMPLES);
+    if (n <= 0 || n != (int)l->enc.nsamples || memcmp(&dec[n - 1], &l->enc.prev, sizeof dec[0]) != 0) {
+        l->bad_frames++;
+    } else {
+        l->decoded += (uint64_t)n;
+    }
+    if (l->out && fwrite(frame, 1, len, l->out) != len) l->bad_frames++;
+}
+
+static void tlm_link_open(tlm_link_t *l) {
+    tlm_init(&l->enc, tlm_link_emit, l);
+    l->out = NULL;
+    l->decoded = 0;
+    l->bad_frames = 0;
+    if (CFG_TLM_DOWNLINK) {
+        l->out = fopen(CFG_TLM_PATH, "wb");
+        if (!l->out) perror(CFG_TLM_PATH);
+    }
+}
+
+static void tlm_link_close(tlm_link_t *l) {
+    tlm_flush(&l->enc);
+    if (l->out) fclose(l->out);
+    l->out = NULL;
+}
+
+/* ------------------------------------------------------------------
+ * 12) Fixed-rate scheduler (rate-monotonic, absolute deadlines)
+ *     A cyclic executive for several periodic tasks in one thread. Each
+ *     task is released on an absolute timeline (start + k * period), so
+ *     jitter never accumulates into drift. Among released tasks the
+ *     lowest priority value runs first (give shorter periods lower values
+ *     for rate-monotonic order). Idle time is spent in clock_nanosleep
+ *     with TIMER_ABSTIME, or busy-polling when any task's period is
+ *     below CFG_SCHED_BUSY_POLL_NS.
+ *       deadline_misses: an instance finished after release + period
+ *       overruns:        releases dropped because the task fell a whole
+ *                        period behind (no burst catch-up)
+ * ------------------------------------------------------------------ */
+#define SCHED_MAX_TASKS 8
+
+typedef int (*sched_fn_t)(void *ctx);
+
+typedef struct {
+    const char *name;
+    sched_fn_t  fn;
+    void       *ctx;
+    uint64_t    period_ns;
+    int         priority;
+    uint64_t    release_ns;      /* next absolute release */
+    uint64_t    runs;
+    uint64_t    errors;          /* fn returned non-zero */
+    uint64_t    deadline_misses;
+    uint64_t    overruns;
+    uint64_t    max_exec_ns;
+    uint64_t    max_latency_ns;  /* release -> start */
+} sched_task_t;
+
+typedef struct {
+    sched_task_t task[SCHED_MAX_TASKS];
+    unsigned     ntasks;
+    int          busy_poll;
+    _Atomic int  stop;
+} sched_t;
+
+/* Registers a task, keeping the table sorted by (priority, period). */
+static int sched_add(sched_t *s, const char *name, uint64_t period_ns, int priority,
+                     sched_fn_t fn, void *ctx) {
+    if (s->ntasks >= SCHED_MAX_TASKS || period_ns == 0 || !fn) return -1;
+    unsigned i = s->ntasks++;
+    while (i > 0 && (s->task[i - 1].priority > priority ||
+                     (s->task[i - 1].priority == priority && s->task[i - 1].period_ns > period_ns))) {
+        s->task[i] = s->task[i - 1];
+        --i;
+    }
+    s->task[i] = (sched_task_t){ .name = name, .fn = fn, .ctx = ctx,
+                                 .period_ns = period_ns, .priority = priority };
+    if (period_ns < CFG_SCHED_BUSY_POLL_NS) s->busy_poll = 1;
+    return 0;
+}
+
+static void sched_wait_until(const sched_t *s, uint64_t t_ns) {
+    if (!s->busy_poll) {
+        struct timespec ts = { (time_t)(t_ns / 1000000000u), (long)(t_ns % 1000000000u) };
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) { /* EINTR */ }
+        return;
+    }
+    while (mono_ns() < t_ns) { /* spin */ }
+}
+
+/* Runs the task set for duration_ns (0 = until sched_stop()). */
+static void sched_run(sched_t *s, uint64_t duration_ns) {
+    uint64_t start = mono_ns();
+    uint64_t end   = duration_ns ? start + duration_ns : UINT64_MAX;
+    for (unsigned i = 0; i < s->ntasks; ++i) s->task[i].release_ns = start;
+
+    while (!atomic_load_explicit(&s->stop, memory_order_relaxed)) {
+        uint64_t now = mono_ns();
+        if (now >= end) break;
+        sched_task_t *t = NULL;
+        uint64_t next = end;
+        for (unsigned i = 0; i < s->ntasks; ++i) {
+            if (s->task[i].release_ns <= now) { t = &s->task[i]; break; }
+            if (s->task[i].release_ns < next) next = s->task[i].release_ns;
+        }
+        if (!t) { sched_wait_until(s, next); continue; }
+
+        uint64_t release = t->release_ns;
+        if (now - release > t->max_latency_ns) t->max_latency_ns = now - release;
+        t->errors += t->fn(t->ctx) != 0;
+        uint64_t done = mono_ns();
+        t->runs++;
+        if (done - now > t->max_exec_ns) t->max_exec_ns = done - now;
+        if (UNLIKELY(done > release + t->period_ns)) {
+            t->deadline_misses++;
+            METRICS_COUNT(deadline_misses);
+        }
+
+        t->release_ns = release + t->period_ns;
+        if (UNLIKELY(t->release_ns + t->period_ns <= done)) {
+            uint64_t behind = (done - t->release_ns) / t->period_ns;
+            t->overruns   += behind;
+            t->release_ns += behind * t->period_ns;
+        }
+    }
+}
+
+static inline void sched_stop(sched_t *s) { atomic_store_explicit(&s->stop, 1, memory_order_relaxed); }
+
+static void sched_report(const sched_t *s) {
+    for (unsigned i = 0; i < s->ntasks; ++i) {
+        const sched_task_t *t = &s->task[i];
+        LOG_PRINTF("[SCHED] %-10s period=%lluus prio=%d runs=%llu errors=%llu "
+                   "misses=%llu overruns=%llu max_exec=%lluns max_latency=%lluns\n",
+                   t->name, (unsigned long long)(t->period_ns / 1000u), t->priority,
+                   (unsigned long long)t->runs, (unsigned long long)t->errors,
+                   (unsigned long long)t->deadline_misses, (unsigned long long)t->overruns,
+                   (unsigned long long)t->max_exec_ns, (unsigned long long)t->max_latency_ns);
+    }
+}
+
+/* Task adapters for the demo schedule */
+static int task_control_loop(void *ctx) {
+    int rc = g_ctl_profile->control_once();
+    if (ctx) tlm_tick((tlm_encoder_t *)ctx);
+    return rc;
+}
+static int task_poll_temperature(void *ctx) { return poll_temperature_c((int *)ctx); }
+static int task_telemetry(void *ctx) {
+    (void)ctx;
+    hw_snapshot_t s;
+    uint32_t tick = hw_snapshot_read(&s);
+    LOGF("TLM #%u CTRL=0x%x STATUS=0x%x THRUST=%u SENS_TEMP=%u", (unsigned)tick,
+         (unsigned)s.CTRL, (unsigned)s.STATUS, (unsigned)s.THRUST, (unsigned)s.SENS_TEMP);
+    (void)tick;
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+ * 13) Main: tie it together
+ * ------------------------------------------------------------------ */
+#ifndef NASA_NO_MAIN
+int main(void) {
+    LOGF("Build: %s %s | C%ld | Hosted=%d",
+         __DATE__, __TIME__, (long)__STDC_VERSION__, (int)__STDC_HOSTED__);
+
+    g_ctl_profile = control_profile_find(CFG_CONTROL_PROFILE);
+    if (!g_ctl_profile) {
+        LOG_PRINTF("Unknown CFG_CONTROL_PROFILE \"%s\"\n", CFG_CONTROL_PROFILE);
+        return EXIT_FAILURE;
+    }
+    LOGF("Control profile: %s (%u N, %u channels)", g_ctl_profile->name,
+         (unsigned)g_ctl_profile->max_thrust_n, (unsigned)g_ctl_profile->channels);
+
+#if CFG_METRICS_SHM && (defined(__GNUC__) || defined(__clang__))
+    if (metrics_open() != 0) {
+        LOG_PRINTF("Metrics: %s unavailable, counting privately\n", CFG_METRICS_SHM_NAME);
+    }
+#endif
+    SAFE_CALL(init_system());
+#if CFG_SENSOR_WAIT && defined(SIM_HW_REGS)
+    SAFE_CALL(sim_adc_start(CFG_ACQ_PERIOD_NS));
+#endif
+
+    /* Self-checks */
+    ASSERT((CFG_MAX_THRUST_N % 10) == 0);
+
+    /* Demo state comes from one static arena sized for exactly these objects */
+    ARENA_DEFINE(demo_arena, sizeof(tlm_link_t) + sizeof(thruster_bank_t) + sizeof(sched_t) + 2 * 64);
+    tlm_link_t      *tlm  = ARENA_NEW(demo_arena, tlm_link_t, 1);
+    thruster_bank_t *bank = ARENA_NEW(demo_arena, thruster_bank_t, 1);
+    ASSERT(tlm && bank);
+
+    /* Per-tick telemetry of the register file */
+    tlm_link_open(tlm);
+
+    /* Demo loop */
+    for (int i = 0; i < 3; ++i) {
+        int rc = g_ctl_profile->control_once();
+        uint64_t boot_dt = boot_note_tick(rc);
+        if (boot_dt) LOGF("Start: first valid tick %llu ns after process start", (unsigned long long)boot_dt);
+        tlm_tick(&tlm->enc);
+        if (rc != ERR_OK) {
+            LOG_PRINTF("ERROR %d: %s\n", rc, error_to_str(rc));
+            break;
+        }
+        /* Mutate temp to exercise policy */
+        SIM_SENSOR_SAMPLE(REG32(SENS_TEMP) + 5u);
+    }
+
+    /* Batched engine: one tick across all thruster channels */
+    for (unsigned ch = 0; ch < CFG_THRUSTER_CHANNELS; ++ch) {
+        bank->temp_c[ch] = (int32_t)(REG32(SENS_TEMP) - 4u * ch);
+    }
+    if (CFG_TEMP_CAL) temp_cal_batch(bank->temp_c, bank->temp_c, CFG_THRUSTER_CHANNELS);
+    (void)g_ctl_profile->bank_once(bank);
+    LOGF("Bank: %u channels, ch0=%u N, ch%u=%u N", (unsigned)g_ctl_profile->channels,
+         bank->thrust_n[0], (unsigned)g_ctl_profile->channels - 1u,
+         bank->thrust_n[g_ctl_profile->channels - 1u]);
+
+    /* Sensor channel bank: one unrolled read of every channel */
+#ifdef SIM_HW_REGS
+#define X(name, desc, gain_q8, offset_q8) REG32(SENS_##name) = 1000u + 100u * SENS_CH_##name;
+    SENSOR_CHANNELS
+#undef X
+#endif
+    sensor_frame_t sens;
+    sensor_read_all(&sens);
+#define X(name, desc, gain_q8, offset_q8) LOGF("Sensor " #name " (" desc "): %d C", (int)sens.name);
+    SENSOR_CHANNELS
+#undef X
+#if CFG_ACT_PIPELINE
+    /* Command every channel: the next ticks keep CFG_ACT_INFLIGHT in flight */
+    for (unsigned ch = 0; ch < g_ctl_profile->channels; ++ch) act_submit(ch, bank->thrust_n[ch]);
+#endif
+
+    /* Multi-rate schedule: 1 kHz control, 2 kHz temperature, 50 Hz telemetry */
+    if (CFG_SCHED_DEMO_MS > 0) {
+        sched_t *sched = ARENA_NEW(demo_arena, sched_t, 1);
+        ASSERT(sched);
+        memset(sched, 0, sizeof *sched);
+        static int latest_temp_c;
+        SAFE_CALL(sched_add(sched, "control", 1000000u, 1, task_control_loop, &tlm->enc));
+        SAFE_CALL(sched_add(sched, "temp_poll", 500000u, 0, task_poll_temperature, &latest_temp_c));
+        SAFE_CALL(sched_add(sched, "telemetry", 20000000u, 2, task_telemetry, NULL));
+        sched_run(sched, (uint64_t)CFG_SCHED_DEMO_MS * 1000000u);
+        sched_report(sched);
+    }
+
+    /* Exercise fault path */
+    SIGNAL_FAULT();
+    int rc = g_ctl_profile->control_once();
+    tlm_tick(&tlm->enc);
+    if (rc != ERR_OK) {
+        LOG_PRINTF("ERROR %d: %s\n", rc, error_to_str(rc));
+    }
+
+#if CFG_ACT_PIPELINE
+    if (act_drain(CFG_ACT_ACK_TIMEOUT_NS) != 0) LOG_PRINTF("Actuator commands not all acknowledged\n");
+    act_log_stats();
+#endif
+#if CFG_SENSOR_ACQ
+    acq_stop();
+    LOGF("Acquisition: %llu samples, %llu dropped, %llu read errors",
+         (unsigned long long)g_acq.samples, (unsigned long long)g_acq.dropped,
+         (unsigned long long)g_acq.read_errors);
+#endif
+#if CFG_SENSOR_WAIT
+#  if defined(SIM_HW_REGS)
+    sim_adc_stop();
+#  endif
+    LOGF("Sensor wait: %llu samples, %llu slept, %llu timeouts",
+         (unsigned long long)g_sensor_wait.samples, (unsigned long long)g_sensor_wait.blocked,
+         (unsigned long long)g_sensor_wait.timeouts);
+#endif
+    DISABLE_SYSTEM();
+    tlm_tick(&tlm->enc);
+    tlm_link_close(tlm);
+    ASSERT(tlm->bad_frames == 0 && tlm->decoded == tlm->enc.samples);
+    LOGF("Telemetry: %llu samples in %llu frames, %llu payload bits (raw %llu)",
+         (unsigned long long)tlm->enc.samples, (unsigned long long)tlm->enc.frames,
+         (unsigned long long)tlm->enc.payload_bits,
+         (unsigned long long)tlm->enc.samples * TLM_REGS * 32u);
+
+    ARENA_LOG_STATS(demo_arena);
+
+    error_stat_t stats[ERR_IDX_COUNT + 1];
+    size_t nstats = error_stats_snapshot(stats, ERR_IDX_COUNT + 1);
+    for (size_t i = 0; i < nstats; ++i) {
+        if (!stats[i].count) continue;
+        if (stats[i].last) {
+            LOGF("Errors: %s x%u, last from %s:%u %s()", stats[i].name, (unsigned)stats[i].count,
+                 stats[i].last->file, (unsigned)stats[i].last->line, stats[i].last->func);
+        } else {
+            LOGF("Errors: %s x%u", stats[i].name, (unsigned)stats[i].count);
+        }
+    }
+#if CFG_SHADOW_REGS
+    LOGF("Shadow regs: %llu puts, %llu unchanged, %llu coalesced, %llu bus writes",
+         (unsigned long long)g_shadow.puts, (unsigned long long)g_shadow.skipped,
+         (unsigned long long)g_shadow.coalesced, (unsigned long long)g_shadow.bus_writes);
+#endif
     return 0;
 }
+#endif /* NASA_NO_MAIN */
@@ -0,0 +1,94 @@
+/*
+ * Ground decoder for the telemetry frames of NASA_SIMPLE_PROJECT.c
+ * ------------------------------------------------------------------
+ * Reads a stream of TLM_FRAME_BYTES frames (CFG_TLM_PATH, or a capture
+ * of the link) and prints one CSV row per tick. Columns and field widths
+ * come from HW_REG_TABLE, so build this from the same tree as the flight
+ * binary. Dropped or corrupt frames are reported and skipped; the next
+ * frame starts with raw values, so decoding resumes there.
+ *
+ * Build:
+ *   gcc -std=c11 -O2 -DGROUND_BUILD -DSIM_HW_REGS NASA_TLM_DECODER.c -o nasa_tlmdec
+ *
+ * Run:
+ *   ./nasa_tlmdec nasa_tlm.bin      CSV: tick,CTRL,STATUS,...
+ *   ./nasa_tlmdec -l                print the frame layout
+ */
+
+#define NASA_NO_MAIN
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "NASA_SIMPLE_PROJECT.c"
+
+static void print_layout(void) {
+    printf("frame: %u bytes = %u-byte header + %u payload bits, %u registers/sample\n",
+           TLM_FRAME_BYTES, TLM_HDR_BYTES, TLM_PAYLOAD_BITS, (unsigned)TLM_REGS);
+    printf("header: u16 magic 0x%04x | u16 seq | u32 first_tick | u16 nsamples | u16 nbits\n",
+           TLM_MAGIC);
+    printf("%-10s %-20s %9s %6s %4s  (bits per sample)\n",
+           "register", "description", "unchanged", "delta", "raw");
+#define X(name, desc, dbits) \
+    printf("%-10s %-20s %9u %6u %4u\n", #name, desc, 1u, 2u + (unsigned)(dbits), 34u);
+    HW_REG_TABLE
+#undef X
+}
+
+static int decode(FILE *f) {
+    static uint8_t      frame[TLM_FRAME_BYTES];
+    static tlm_sample_t s[TLM_MAX_SAMPLES];
+    uint64_t frames = 0, bad = 0, gaps = 0, samples = 0;
+    uint32_t next_tick = 0, next_seq = 0;
+
+    printf("tick");
+#define X(name, desc, dbits) printf("," #name);
+    HW_REG_TABLE
+#undef X
+    putchar('\n');
+
+    while (fread(frame, 1, sizeof frame, f) == sizeof frame) {
+        uint32_t tick = 0;
+        int n = tlm_decode_frame(frame, sizeof frame, &tick, s, TLM_MAX_SAMPLES);
+        if (n < 0) {
+            fprintf(stderr, "[TLMDEC] frame %llu: corrupt, skipped\n", (unsigned long long)frames);
+            ++frames;
+            ++bad;
+            continue;
+        }
+        uint32_t seq = tlm_rd16(frame + 2);
+        if (frames != bad && (seq != (next_seq & 0xFFFFu) || tick != next_tick)) {
+            fprintf(stderr, "[TLMDEC] gap before seq %u: ticks %u..%u missing\n",
+                    (unsigned)seq, (unsigned)next_tick, (unsigned)(tick - 1u));
+            ++gaps;
+        }
+        for (int i = 0; i < n; ++i) {
+            printf("%u", (unsigned)(tick + (uint32_t)i));
+#define X(name, desc, dbits) printf(",%u", (unsigned)s[i].name);
+            HW_REG_TABLE
+#undef X
+            putchar('\n');
+        }
+        next_seq  = seq + 1u;
+        next_tick = tick + (uint32_t)n;
+        samples  += (uint64_t)n;
+        ++frames;
+    }
+    fprintf(stderr, "[TLMDEC] %llu frames, %llu samples, %llu corrupt, %llu gaps\n",
+            (unsigned long long)frames, (unsigned long long)samples,
+            (unsigned long long)bad, (unsigned long long)gaps);
+    return bad ? -1 : 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc == 2 && !strcmp(argv[1], "-l")) {
+        print_layout();
+        return EXIT_SUCCESS;
+    }
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <frames.bin> | -l\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    FILE *f = fopen(argv[1], "rb");
+    if (!f) { perror(argv[1]); return EXIT_FAILURE; }
+    int rc = decode(f);
+    fclose(f);
+    return rc == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,3 +1,6 @@
+#include <stdio.h>
+#include <stdlib.h>
+
 /*
  * MACRO: SAFE_CALL
  * Purpose:
@@ -16,3 +19,38 @@
             exit(EXIT_FAILURE); \
         } \
     } while (0)
+
+/*
+ * MACRO: SAFE_CALL_COLD
+ * Purpose:
+ *   Same contract and message as SAFE_CALL, but the call site keeps only
+ *   the compare and one branch. The report/exit code is shared by every
+ *   site in safe_call_fail(), which is kept out of line and in the cold
+ *   text section; each site passes a static descriptor instead of
+ *   materializing __FILE__/__LINE__/#call arguments inline.
+ * Usage:
+ *   SAFE_CALL_COLD(init_sensor());
+ * Constraints:
+ *   Must be safe for use in if/else blocks without braces.
+ *   Needs GCC/Clang for the noinline/cold/noreturn attributes.
+ */
+typedef struct {
+    const char *file;
+    int         line;
+    const char *call;
+} safe_call_site_t;
+
+__attribute__((noinline, cold, noreturn, unused))
+static void safe_call_fail(const safe_call_site_t *site, int rc) {
+    fprintf(stderr, "[%s:%d] %s failed with code %d\n", site->file, site->line, site->call, rc);
+    exit(EXIT_FAILURE);
+}
+
+#define SAFE_CALL_COLD(call) \
+    do { \
+        int rc = (call); \
+        if (__builtin_expect(rc != 0, 0)) { \
+            static const safe_call_site_t site_ = { __FILE__, __LINE__, #call }; \
+            safe_call_fail(&site_, rc); \
+        } \
+    } while (0)
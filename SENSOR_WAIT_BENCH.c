@@ -0,0 +1,91 @@
+/*
+ * Sensor wait: CPU use vs. wake-up latency
+ * ------------------------------------------------------------------
+ * The simulated ADC (sim_adc_start) raises a new-sample interrupt every
+ * period; the main thread loops on READ_TEMP_WAIT(), the read an
+ * event-driven control loop makes, and measures its own CPU time and how
+ * long after each interrupt it woke. Build the spin budgets side by side
+ * (0 = always sleep, huge = pure spin, which is what the polling loop
+ * used to cost):
+ *
+ *   for s in 0 20000 1000000000; do
+ *     gcc -std=c11 -O2 -DFLIGHT_BUILD -DSIM_HW_REGS -DCFG_SENSOR_WAIT=1 \
+ *         -DCFG_SENSOR_SPIN_NS=$s -pthread SENSOR_WAIT_BENCH.c -o sw_$s && ./sw_$s
+ *   done
+ *
+ * Options:
+ *   -p <us>   sample period (default 100, i.e. 10 kHz)
+ *   -d <ms>   run time (default 2000)
+ */
+
+#define NASA_NO_MAIN
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "NASA_SIMPLE_PROJECT.c"
+
+#include <unistd.h>
+
+#if !defined(SIM_HW_REGS) || !CFG_SENSOR_WAIT
+#  error "SENSOR_WAIT_BENCH.c needs the simulated ADC: build with -DSIM_HW_REGS -DCFG_SENSOR_WAIT=1 -pthread"
+#endif
+
+#define LAT_BUCKETS 4096u          /* 1 us buckets; the last one is >= 4 ms */
+
+static uint64_t lat_hist[LAT_BUCKETS];
+
+static uint64_t lat_percentile(uint64_t n, double p) {
+    uint64_t want = (uint64_t)(p * (double)n), seen = 0;
+    for (unsigned i = 0; i < LAT_BUCKETS; ++i) {
+        seen += lat_hist[i];
+        if (seen > want) return i;
+    }
+    return LAT_BUCKETS - 1u;
+}
+
+static uint64_t thread_cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t period_us = 100, dur_ms = 2000;
+    int opt;
+    while ((opt = getopt(argc, argv, "p:d:")) != -1) {
+        switch (opt) {
+        case 'p': period_us = strtoull(optarg, NULL, 10); break;
+        case 'd': dur_ms = strtoull(optarg, NULL, 10); break;
+        default:
+            fprintf(stderr, "usage: %s [-p period_us] [-d ms]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (period_us == 0) period_us = 1;
+
+    uint32_t seen = atomic_load(&HW.sens_irq);
+    if (sim_adc_start(period_us * 1000u) != 0) { perror("sim_adc_start"); return EXIT_FAILURE; }
+
+    uint64_t wakes = 0, timeouts = 0, lat_max = 0;
+    uint64_t cpu0 = thread_cpu_ns(), t0 = mono_ns(), end = t0 + dur_ms * 1000000u;
+    while (mono_ns() < end) {
+        int raw = 0;
+        if (READ_TEMP_WAIT(&raw, &seen, CFG_SENSOR_WAIT_TIMEOUT_NS) != 0) { ++timeouts; continue; }
+        uint64_t lat = mono_ns() - atomic_load_explicit(&g_sim_adc.last_ns, memory_order_relaxed);
+        if (lat > lat_max) lat_max = lat;
+        lat_hist[lat / 1000u < LAT_BUCKETS ? lat / 1000u : LAT_BUCKETS - 1u]++;
+        ++wakes;
+    }
+    uint64_t cpu1 = thread_cpu_ns(), t1 = mono_ns();
+    sim_adc_stop();
+
+    double wall = (double)(t1 - t0);
+    printf("sensor wait: spin %u ns, period %llu us, %.1f s\n", (unsigned)CFG_SENSOR_SPIN_NS,
+           (unsigned long long)period_us, wall / 1e9);
+    printf("samples      %llu of %llu raised, %llu slept, %llu timeouts\n",
+           (unsigned long long)wakes, (unsigned long long)atomic_load(&g_sim_adc.raised),
+           (unsigned long long)atomic_load(&g_sensor_wait.blocked), (unsigned long long)timeouts);
+    printf("waiter cpu   %.1f%% of one core\n", 100.0 * (double)(cpu1 - cpu0) / wall);
+    printf("wake-up      p50 <%llu us  p99 <%llu us  max %.1f us\n",
+           (unsigned long long)lat_percentile(wakes, 0.50) + 1u,
+           (unsigned long long)lat_percentile(wakes, 0.99) + 1u, (double)lat_max / 1e3);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,268 @@
+/*
+ * Monte Carlo simulation farm for NASA_SIMPLE_PROJECT.c
+ * ------------------------------------------------------------------
+ * Runs many independent vehicle scenarios in one process. Each scenario
+ * owns a hw_regs_t instance that its worker binds with hw_bind(), so the
+ * unmodified init_system()/run_control_loop_once() drive that vehicle.
+ * Scenarios are spread over one worker thread per core. A worker owns a
+ * contiguous range of scenario ids and takes from its front; an idle
+ * worker steals the back half of the fullest range. Both ends move with
+ * one CAS on a packed (lo, hi) word, so there are no locks. Per-worker
+ * totals are merged after the join.
+ *
+ * Build (flight profile: no per-tick logging, no shared profile records):
+ *   gcc -std=c11 -O2 -DFLIGHT_BUILD -DSIM_HW_REGS -pthread SIM_FARM.c -o nasa_farm
+ *
+ * Run:
+ *   ./nasa_farm [-n scenarios] [-t ticks] [-j threads] [-s seed]
+ *   defaults: 100000 scenarios x 1000 ticks, one thread per online core
+ *
+ * Scenario model: thermal state in milli-degC with a random start, drift
+ * and noise; high thrust heats the vehicle, low thrust lets it cool. One
+ * scenario in ten injects a fault at a random tick, and the run stops at
+ * the first non-OK return of the control loop.
+ */
+
+#define _GNU_SOURCE                  /* pthread_setaffinity_np */
+#define NASA_NO_MAIN
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "NASA_SIMPLE_PROJECT.c"
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#ifndef SIM_HW_REGS
+#  error "SIM_FARM.c runs simulated vehicles: build with -DSIM_HW_REGS"
+#endif
+#if CFG_SENSOR_ACQ
+#  error "SIM_FARM.c binds register files per thread: build without CFG_SENSOR_ACQ"
+#endif
+#if CFG_ENABLE_LOGS && CFG_PROFILE
+#  error "PROFILE_SCOPE records are single-threaded: use FLIGHT_BUILD or -DCFG_PROFILE=0"
+#endif
+#if CFG_TEMP_CAL
+#  error "the scenario model writes degC into SENS_TEMP: build with CFG_TEMP_CAL=0"
+#endif
+#if CFG_WARM_START
+#  error "SIM_FARM.c runs many control threads: build with CFG_WARM_START=0"
+#endif
+
+#define FARM_MAX_THREADS 256u
+
+typedef struct {
+    uint32_t ticks;          /* ticks actually run */
+    int32_t  rc;             /* first non-OK return, or ERR_OK */
+    int32_t  max_temp_mc;
+    uint32_t hot_ticks;      /* ticks at POLICY_HOT_N */
+    uint64_t impulse;        /* sum of THRUST over the run, N*ticks */
+} scenario_result_t;
+
+typedef struct {
+    uint64_t scenarios;
+    uint64_t ticks;
+    uint64_t hot_ticks;
+    uint64_t impulse;
+    uint64_t by_err[ERR_IDX_COUNT + 1];
+    int32_t  max_temp_mc;
+    uint32_t worst;          /* scenario id of max_temp_mc */
+} farm_acc_t;
+
+typedef struct {
+    CACHELINE_ALIGNED _Atomic uint64_t range; /* lo | hi << 32: ids still owned */
+    uint64_t   steals;                    /* successful steals by this worker */
+    farm_acc_t acc;
+    pthread_t  tid;
+    unsigned   index;
+} farm_worker_t;
+
+static farm_worker_t     *g_workers;
+static unsigned           g_nworkers;
+static scenario_result_t *g_results;
+static uint32_t           g_ticks;
+static uint64_t           g_seed;
+
+static inline uint64_t range_pack(uint32_t lo, uint32_t hi) { return (uint64_t)lo | (uint64_t)hi << 32; }
+
+static inline uint64_t splitmix64(uint64_t *s) {
+    uint64_t z = (*s += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static void run_scenario(uint32_t id, scenario_result_t *res) {
+    uint64_t rng = g_seed ^ ((uint64_t)id * 0xD1B54A32D192ED03ull);
+    int32_t  temp_mc  = (int32_t)(splitmix64(&rng) % 60000u);          /* 0..60 degC */
+    int32_t  drift_mc = (int32_t)(splitmix64(&rng) % 41u) - 20;        /* per tick */
+    uint32_t noise_mc = 1u + (uint32_t)(splitmix64(&rng) % 500u);
+    uint32_t fault_at = splitmix64(&rng) % 10u == 0 ? (uint32_t)(splitmix64(&rng) % g_ticks)
+                                                    : UINT32_MAX;
+    hw_regs_t regs = {0};
+    hw_regs_t *prev = hw_bind(&regs);
+    *res = (scenario_result_t){ 0, ERR_OK, temp_mc, 0, 0 };
+
+    int rc = init_system();
+    for (uint32_t t = 0; t < g_ticks && rc == ERR_OK; ++t) {
+        if (UNLIKELY(t == fault_at)) SIGNAL_FAULT();
+        SIM_SENSOR_SAMPLE(temp_mc > 0 ? (uint32_t)temp_mc / 1000u : 0u);
+        rc = run_control_loop_once();
+        uint32_t thrust = REG32(THRUST);
+        res->ticks++;
+        res->impulse   += thrust;
+        res->hot_ticks += thrust == POLICY_HOT_N;
+        /* high thrust heats, low thrust cools, around a +/-noise walk */
+        temp_mc += drift_mc + (thrust >= POLICY_COLD_N ? 15 : -15) +
+                   (int32_t)(splitmix64(&rng) % (2u * noise_mc + 1u)) - (int32_t)noise_mc;
+        if (temp_mc > res->max_temp_mc) res->max_temp_mc = temp_mc;
+    }
+    res->rc = rc;
+    DISABLE_SYSTEM();
+    hw_bind(prev);
+}
+
+/* Next id from the front of our own range, or -1 when it is empty */
+static int64_t take_own(farm_worker_t *w) {
+    uint64_t r = atomic_load_explicit(&w->range, memory_order_acquire);
+    for (;;) {
+        uint32_t lo = (uint32_t)r, hi = (uint32_t)(r >> 32);
+        if (lo >= hi) return -1;
+        if (atomic_compare_exchange_weak_explicit(&w->range, &r, range_pack(lo + 1u, hi),
+                                                  memory_order_acq_rel, memory_order_acquire)) {
+            return lo;
+        }
+    }
+}
+
+/* Move the back half of the fullest other range into ours; -1 if none left */
+static int64_t steal(farm_worker_t *w) {
+    for (;;) {
+        farm_worker_t *victim = NULL;
+        uint64_t best = 0, r = 0;
+        for (unsigned i = 0; i < g_nworkers; ++i) {
+            farm_worker_t *v = &g_workers[i];
+            if (v == w) continue;
+            uint64_t vr = atomic_load_explicit(&v->range, memory_order_acquire);
+            uint32_t lo = (uint32_t)vr, hi = (uint32_t)(vr >> 32);
+            if (hi > lo && hi - lo > best) { best = hi - lo; victim = v; r = vr; }
+        }
+        if (!victim) return -1;
+        uint32_t lo = (uint32_t)r, hi = (uint32_t)(r >> 32), mid = lo + (hi - lo) / 2u;
+        if (atomic_compare_exchange_strong_explicit(&victim->range, &r, range_pack(lo, mid),
+                                                    memory_order_acq_rel, memory_order_acquire)) {
+            atomic_store_explicit(&w->range, range_pack(mid + 1u, hi), memory_order_release);
+            w->steals++;
+            return mid;
+        }
+    }
+}
+
+static void accumulate(farm_acc_t *a, uint32_t id, const scenario_result_t *r) {
+    a->scenarios++;
+    a->ticks     += r->ticks;
+    a->hot_ticks += r->hot_ticks;
+    a->impulse   += r->impulse;
+    a->by_err[error_index((error_t)r->rc)]++;
+    if (a->scenarios == 1 || r->max_temp_mc > a->max_temp_mc) {
+        a->max_temp_mc = r->max_temp_mc;
+        a->worst = id;
+    }
+}
+
+static void *worker_main(void *arg) {
+    farm_worker_t *w = arg;
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpu > 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET((int)(w->index % (unsigned)ncpu), &set);
+        (void)pthread_setaffinity_np(pthread_self(), sizeof set, &set);
+    }
+    int64_t id;
+    while ((id = take_own(w)) >= 0 || (id = steal(w)) >= 0) {
+        run_scenario((uint32_t)id, &g_results[id]);
+        accumulate(&w->acc, (uint32_t)id, &g_results[id]);
+    }
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t n = 100000u;
+    long     threads = sysconf(_SC_NPROCESSORS_ONLN);
+    int      opt;
+    g_ticks = 1000u;
+    g_seed  = 1u;
+    while ((opt = getopt(argc, argv, "n:t:j:s:")) != -1) {
+        switch (opt) {
+        case 'n': n = strtoull(optarg, NULL, 10); break;
+        case 't': g_ticks = (uint32_t)strtoul(optarg, NULL, 10); break;
+        case 'j': threads = atol(optarg); break;
+        case 's': g_seed = strtoull(optarg, NULL, 10); break;
+        default:
+            fprintf(stderr, "usage: %s [-n scenarios] [-t ticks] [-j threads] [-s seed]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (n == 0 || n >= UINT32_MAX || g_ticks == 0) {
+        fprintf(stderr, "need 0 < scenarios < 2^32 and ticks > 0\n");
+        return EXIT_FAILURE;
+    }
+    if (threads < 1) threads = 1;
+    if (threads > (long)FARM_MAX_THREADS) threads = FARM_MAX_THREADS;
+    g_nworkers = (unsigned)threads;
+    g_workers  = aligned_alloc(CACHELINE_SIZE, sizeof(farm_worker_t) * g_nworkers);
+    g_results  = calloc((size_t)n, sizeof *g_results);
+    if (!g_workers || !g_results) { perror("alloc"); return EXIT_FAILURE; }
+    memset(g_workers, 0, sizeof(farm_worker_t) * g_nworkers);
+    for (unsigned i = 0; i < g_nworkers; ++i) {
+        g_workers[i].index = i;
+        atomic_init(&g_workers[i].range, range_pack((uint32_t)(n * i / g_nworkers),
+                                                    (uint32_t)(n * (i + 1u) / g_nworkers)));
+    }
+
+    uint64_t t0 = mono_ns();
+    for (unsigned i = 0; i < g_nworkers; ++i) {
+        if (pthread_create(&g_workers[i].tid, NULL, worker_main, &g_workers[i]) != 0) {
+            perror("pthread_create");
+            return EXIT_FAILURE;
+        }
+    }
+    farm_acc_t total = {0};
+    uint64_t   steals = 0;
+    for (unsigned i = 0; i < g_nworkers; ++i) {
+        pthread_join(g_workers[i].tid, NULL);
+        const farm_acc_t *a = &g_workers[i].acc;
+        if (a->scenarios && (total.scenarios == 0 || a->max_temp_mc > total.max_temp_mc)) {
+            total.max_temp_mc = a->max_temp_mc;
+            total.worst = a->worst;
+        }
+        total.scenarios += a->scenarios;
+        total.ticks     += a->ticks;
+        total.hot_ticks += a->hot_ticks;
+        total.impulse   += a->impulse;
+        for (unsigned e = 0; e <= ERR_IDX_COUNT; ++e) total.by_err[e] += a->by_err[e];
+        steals += g_workers[i].steals;
+    }
+    double secs = (double)(mono_ns() - t0) / 1e9;
+
+    printf("farm: %llu scenarios x %u ticks on %u threads, seed %llu\n",
+           (unsigned long long)n, (unsigned)g_ticks, g_nworkers, (unsigned long long)g_seed);
+    printf("time              %.3f s  (%.0f scenarios/s, %.1f Mticks/s)\n", secs,
+           (double)total.scenarios / secs, (double)total.ticks / secs / 1e6);
+    printf("steals            %llu\n", (unsigned long long)steals);
+    printf("hot-policy ticks  %.2f%%\n",
+           total.ticks ? 100.0 * (double)total.hot_ticks / (double)total.ticks : 0.0);
+    printf("mean thrust       %.1f N\n",
+           total.ticks ? (double)total.impulse / (double)total.ticks : 0.0);
+    printf("max temperature   %.3f C  (scenario %u)\n", total.max_temp_mc / 1000.0,
+           (unsigned)total.worst);
+    error_stat_t stats[ERR_IDX_COUNT + 1];
+    size_t nstats = error_stats_snapshot(stats, ERR_IDX_COUNT + 1);
+    for (size_t i = 0; i < nstats; ++i) {   /* snapshot order == error_index() order */
+        if (total.by_err[i]) printf("ended %-16s %llu scenarios\n", stats[i].name,
+                                    (unsigned long long)total.by_err[i]);
+    }
+    free(g_results);
+    free(g_workers);
+    return total.scenarios == n ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,6 +1,15 @@
-#include <stdio.h>
-
-#define TRACE() printf("TRACE: %s() called at %s:%d\n", __func__, __FILE__, __LINE__)
+#ifdef TRACE_RING
+/* Enter/exit events into per-thread rings, dumped as Chrome trace JSON at
+ * exit (the tracer from NASA_SIMPLE_PROJECT.c, section 4):
+ *   gcc -std=c11 -O2 -DTRACE_RING -DGROUND_BUILD -DSIM_HW_REGS -DCPU_RISCV function_tracer_MACRO.c */
+#  define NASA_NO_MAIN
+#  define CFG_TRACE_RING 1
+#  pragma GCC diagnostic ignored "-Wunused-function"
+#  include "NASA_SIMPLE_PROJECT.c"
+#else
+#  include <stdio.h>
+#  define TRACE() printf("TRACE: %s() called at %s:%d\n", __func__, __FILE__, __LINE__)
+#endif
 
 void hello() {
     TRACE();